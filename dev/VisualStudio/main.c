@@ -9,6 +9,8 @@
 extern const ow_ll_drv_t ow_ll_drv_win32;
 ow_t ow;
 ow_rom_t rom_ids[20];
+ow_ds18x20_result_t results[20];
+ow_ds18x20_cache_t ds_cache[20];
 size_t rom_found;
 
 /**
@@ -19,6 +21,7 @@ main(void) {
     printf("Starting OneWire application..\r\n");
 
     ow_init(&ow, &ow_ll_drv_win32, NULL);       /* Initialize 1-Wire library and set user argument to 1 */
+    ow_ds18x20_cache_attach(&ow, ds_cache, OW_ARRAYSIZE(ds_cache));
 
     /* Get onewire devices connected on 1-wire port */
     while (1) {
@@ -35,22 +38,18 @@ main(void) {
             for (size_t c = 0; c < 5; c++) {
                 printf("Start temperature conversion\r\n");
 
-                ow_ds18x20_start(&ow, NULL);    /* Start conversion on all devices */
-                Sleep(1500);                    /* Release thread for 1 second */
-
-                /* Read temperature on all devices */
-                ow_protect(&ow, 1);
+                /* Start conversion on all devices, wait to complete and read all sensors */
+                if (ow_ds18x20_read_all(&ow, rom_ids, rom_found, results) != owOK) {
+                    printf("Temperature conversion error\r\n");
+                    continue;
+                }
                 for (size_t i = 0; i < rom_found; ++i) {
-                    if (ow_ds18x20_is_b(&ow, &rom_ids[i])) {
-                        float temp;
-                        uint8_t resolution = ow_ds18x20_get_resolution_raw(&ow, &rom_ids[i]);
-                        if (ow_ds18x20_read_raw(&ow, &rom_ids[i], &temp)) {
-                            printf("Sensor %3u temperature is %d.%03d degrees (%u bits resolution)\r\n",
-                                (unsigned)i, (int)temp, (int)((temp * 1000.0f) - (((int)temp) * 1000)), (unsigned)resolution);
-                        }
+                    if (results[i].status == owOK) {
+                        float temp = (float)results[i].mcelsius / 1000.0f;
+                        printf("Sensor %3u temperature is %d.%03d degrees (%u bits resolution)\r\n",
+                            (unsigned)i, (int)temp, (int)((temp * 1000.0f) - (((int)temp) * 1000)), (unsigned)results[i].resolution);
                     }
                 }
-                ow_unprotect(&ow, 1);
             }
         }
     }
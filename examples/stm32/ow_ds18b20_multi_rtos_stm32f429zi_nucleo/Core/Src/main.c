@@ -80,8 +80,8 @@ static ow_uart_link_t ow_uart_link_1 = { .id = 1, .ow = &ow1, .uart = &huart1 };
 static ow_uart_link_t ow_uart_link_2 = { .id = 2, .ow = &ow2, .uart = &huart2 };
 static ow_uart_link_t ow_uart_link_3 = { .id = 3, .ow = &ow3, .uart = &huart6 };
 
-/* Use extern low-level for OW using HAL */
-extern const ow_ll_drv_t ow_ll_drv_stm32_hal;
+/* Use extern low-level for OW using HAL with DMA */
+extern const ow_ll_drv_t ow_ll_drv_stm32_hal_dma;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -474,7 +474,7 @@ void start_ow_task(void *argument)
     }
 
     /* Initialize OW instance */
-    res = ow_init(link->ow, &ow_ll_drv_stm32_hal, link->uart);
+    res = ow_init(link->ow, &ow_ll_drv_stm32_hal_dma, link->uart);
 
     /* Initialize OW with UART instance as custom parameter */
     safeprintf("[OW %d] Init OW: %d\r\n", (int)link->id, (int)res);
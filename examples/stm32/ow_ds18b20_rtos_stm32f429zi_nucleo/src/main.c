@@ -104,11 +104,12 @@ app_thread(void* arg) {
             avg_temp_count = 0;
             for (size_t i = 0; i < rom_found; i++) {
                 if (ow_ds18x20_is_b(&ow, &rom_ids[i])) {
-                    float temp;
-                    uint8_t resolution = ow_ds18x20_get_resolution(&ow, &rom_ids[i]);
-                    if (ow_ds18x20_read(&ow, &rom_ids[i], &temp)) {
+                    ow_ds18x20_result_t r;
+                    if (ow_ds18x20_read_ex(&ow, &rom_ids[i], &r) == owOK) {
+                        float temp = (float)r.mcelsius / 1000.0f;
+
                         printf("Sensor %02u temperature is %d.%d degrees (%u bits resolution)\r\n",
-                            (unsigned)i, (int)temp, (int)((temp * 1000.0f) - (((int)temp) * 1000)), (unsigned)resolution);
+                            (unsigned)i, (int)temp, (int)((temp * 1000.0f) - (((int)temp) * 1000)), (unsigned)r.resolution);
 
                         avg_temp += temp;
                         avg_temp_count++;
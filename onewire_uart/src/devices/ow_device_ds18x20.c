@@ -31,9 +31,537 @@
  * Author:          Tilen MAJERLE <tilen@majerle.eu>
  * Version:         v2.0.0
  */
+#include <string.h>
 #include "ow/ow.h"
 #include "ow/devices/ow_device_ds18x20.h"
 
+#if !__DOXYGEN__
+
+/* Internal macros */
+#define OW_DS18X20_CMD_CONVERT          0x44
+#define OW_DS18X20_CMD_ALARM_SEARCH     0xEC
+#define OW_DS18X20_SCRATCHPAD_LEN       9
+#define OW_DS18X20_POWER_ON_RAW         0x0550  /* 85 degrees, temperature register value after power-on */
+
+/* EEPROM write time in units of milliseconds, for copy scratchpad command */
+#define OW_DS18X20_COPY_TIME            10
+
+/* Cache entry flags */
+#define OW_DS18X20_CACHE_FLAG_USED      0x01    /* Entry is assigned to device */
+#define OW_DS18X20_CACHE_FLAG_CONF      0x02    /* Alarm and configuration registers are known */
+#define OW_DS18X20_CACHE_FLAG_POWER     0x04    /* Power supply mode is known */
+#define OW_DS18X20_CACHE_FLAG_PARASITIC 0x08    /* Device is parasitically powered */
+#define OW_DS18X20_CACHE_FLAG_DIRTY     0x10    /* Registers differ from EEPROM content */
+#define OW_DS18X20_CACHE_FLAG_TEMP      0x20    /* Last temperature and its time are valid */
+
+/* Number of bytes to start conversion of single device: match ROM, ROM address and convert command */
+#define OW_DS18X20_START_BYTES          (1 + 8 + 1)
+
+/* Number of bytes to read scratchpad of single device: match ROM, ROM address, read command and scratchpad */
+#define OW_DS18X20_READ_BYTES           (1 + 8 + 1 + OW_DS18X20_SCRATCHPAD_LEN)
+
+/* Mask of defined temperature bits for resolution set in configuration register: -8, -4, -2 or -1 */
+#define OW_DS18X20_RES_MASK(conf)       (-(8 >> (((conf) >> 0x05) & 0x03)))
+
+/* Maximal conversion time in units of milliseconds for specific resolution in units of bits */
+#define OW_DS18X20_CONV_TIME(bits)      ((uint32_t)750 >> (12 - (bits)))
+
+/* Number of read bytes, each with 8 read slots at data baudrate, to cover `ms` milliseconds */
+#define OW_DS18X20_POLL_BYTES(ms)       ((ms) * (OW_BAUD_DATA / 10) / 8 / 1000)
+
+#endif /* !__DOXYGEN__ */
+
+/**
+ * \brief           Reset bus, select device(s) and send function command
+ *
+ * ROM command, ROM address and function command are sent with single batched transfer
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to select.
+ *                      Set to `NULL` to skip ROM and select all devices
+ * \param[in]       cmd: Function command to send to selected device(s)
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_send_cmd(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t cmd) {
+    uint8_t tx[1 + sizeof(rom_id->rom) + 1], len = 0;
+    owr_t res;
+
+    if ((res = ow_reset_raw(ow)) != owOK) {
+        return res;
+    }
+    if (rom_id == NULL) {                       /* Check for ROM id */
+        tx[len++] = OW_CMD_SKIPROM;             /* Skip ROM, send to all devices */
+    } else {
+        tx[len++] = OW_CMD_MATCHROM;            /* Select exact device by ROM address */
+        memcpy(&tx[len], rom_id->rom, sizeof(rom_id->rom));
+        len += sizeof(rom_id->rom);
+    }
+    tx[len++] = cmd;
+    return ow_write_bytes_ex_raw(ow, tx, NULL, len);
+}
+
+/**
+ * \brief           Read first `len` bytes of device scratchpad
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to read from.
+ *                      Set to `NULL` to skip ROM, when single device is on the bus
+ * \param[out]      data: Output array to save scratchpad data
+ * \param[in]       len: Number of bytes to read, up to `9`
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_read_scratchpad(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const data, const size_t len) {
+    owr_t res;
+
+    if ((res = prv_send_cmd(ow, rom_id, OW_CMD_RSCRATCHPAD)) != owOK) {
+        return res;
+    }
+    return ow_read_bytes_ex_raw(ow, data, len);
+}
+
+/**
+ * \brief           Decode temperature from scratchpad data
+ * \param[in]       rom_id: 1-Wire device address data belongs to, used to detect `DS18S20`.
+ *                      Set to `NULL` to decode as `DS18B20`
+ * \param[in]       data: Scratchpad data, at least `5` bytes
+ * \param[out]      resolution: Output variable to save resolution in units of bits. Set to `NULL` if not used
+ * \return          Temperature in units of `1/16` degree Celsius
+ */
+static int16_t
+prv_decode_raw(const ow_rom_t* const rom_id, const uint8_t* const data, uint8_t* const resolution) {
+    int16_t raw = (int16_t)((data[1] << 0x08) | data[0]);
+    uint8_t bits;
+
+    if (rom_id != NULL && rom_id->rom[0] == 0x10) {
+        bits = 9;                               /* DS18S20 has fixed resolution */
+        raw = (int16_t)(raw * 8);               /* LSB is 0.5 degree, convert to 1/16 units */
+    } else {
+        bits = ((data[4] & 0x60) >> 0x05) + 0x09;   /* Resolution in units of bits */
+        raw = (int16_t)(raw & OW_DS18X20_RES_MASK(data[4]));
+    }
+    if (resolution != NULL) {
+        *resolution = bits;
+    }
+    return raw;
+}
+
+/**
+ * \brief           Check if devices completed with temperature conversion or EEPROM write
+ *
+ * Devices keep the line low on read slot while operation is in progress.
+ * Read slots are sent in batches of `8`, to improve transfer efficiency
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[out]      done: Output variable set to `1` when operation completed, `0` otherwise
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_check_done(ow_t* const ow, uint8_t* const done) {
+    uint8_t br;
+    owr_t res;
+
+    if ((res = ow_read_byte_ex_raw(ow, &br)) == owOK) {
+        *done = br != 0x00;                     /* Any released slot means operation completed */
+    }
+    return res;
+}
+
+/**
+ * \brief           Limit alarm temperature to valid range of the device
+ * \param[in]       temp: Alarm temperature in units of degree Celsius, or \ref OW_DS18X20_ALARM_DISABLE
+ * \param[in]       disabled: Value to use when alarm is disabled
+ * \return          Alarm temperature to write to device
+ */
+static int8_t
+prv_alarm_level(const int8_t temp, const int8_t disabled) {
+    if (temp == OW_DS18X20_ALARM_DISABLE) {
+        return disabled;
+    }
+    return temp < OW_DS18X20_TEMP_MIN ? OW_DS18X20_TEMP_MIN : (temp > OW_DS18X20_TEMP_MAX ? OW_DS18X20_TEMP_MAX : temp);
+}
+
+/**
+ * \brief           Mark alarm and configuration registers of all cached devices as unknown
+ * \param[in]       ow: 1-Wire handle
+ */
+static void
+prv_cache_forget_config(ow_t* const ow) {
+#if OW_CFG_DS18X20_CACHE
+    ow_ds18x20_cache_t* entries = ow->ds18x20_cache;
+
+    for (size_t i = 0; i < ow->ds18x20_cache_len; ++i) {
+        entries[i].flags &= ~(OW_DS18X20_CACHE_FLAG_CONF | OW_DS18X20_CACHE_FLAG_DIRTY);
+    }
+#else
+    OW_UNUSED(ow);
+#endif /* OW_CFG_DS18X20_CACHE */
+}
+
+/**
+ * \brief           Get cache entry of the device
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       create: Set to `1` to assign free entry, when device is not in the cache yet
+ * \return          Pointer to cache entry on success, `NULL` otherwise
+ */
+static ow_ds18x20_cache_t*
+prv_cache_get(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t create) {
+#if OW_CFG_DS18X20_CACHE
+    ow_ds18x20_cache_t* entries = ow->ds18x20_cache, *free_entry = NULL;
+
+    if (rom_id == NULL || entries == NULL) {
+        return NULL;
+    }
+    for (size_t i = 0; i < ow->ds18x20_cache_len; ++i) {
+        if (entries[i].flags & OW_DS18X20_CACHE_FLAG_USED) {
+            if (memcmp(entries[i].rom.rom, rom_id->rom, sizeof(rom_id->rom)) == 0) {
+                return &entries[i];
+            }
+        } else if (free_entry == NULL) {
+            free_entry = &entries[i];
+        }
+    }
+    if (create && free_entry != NULL) {
+        memcpy(&free_entry->rom, rom_id, sizeof(*rom_id));
+        free_entry->flags = OW_DS18X20_CACHE_FLAG_USED;
+        return free_entry;
+    }
+#else
+    OW_UNUSED(ow);
+    OW_UNUSED(rom_id);
+    OW_UNUSED(create);
+#endif /* OW_CFG_DS18X20_CACHE */
+    return NULL;
+}
+
+/**
+ * \brief           Update cache entry with registers from CRC-verified scratchpad
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       data: Scratchpad data
+ */
+static void
+prv_cache_update(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t* const data) {
+    ow_ds18x20_cache_t* c;
+
+    if ((c = prv_cache_get(ow, rom_id, 1)) != NULL) {
+        c->th = data[2];
+        c->tl = data[3];
+        c->conf = data[4];
+        c->flags |= OW_DS18X20_CACHE_FLAG_CONF;
+    }
+}
+
+/**
+ * \brief           Save temperature of completed conversion to cache
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       raw: Temperature in units of `1/16` degree Celsius
+ */
+static void
+prv_cache_temp(ow_t* const ow, const ow_rom_t* const rom_id, const int16_t raw) {
+#if OW_CFG_OS
+    ow_ds18x20_cache_t* c;
+
+    if ((c = prv_cache_get(ow, rom_id, 1)) != NULL) {
+        c->raw = raw;
+        c->tick = ow_sys_get_tick(ow->arg);
+        c->flags |= OW_DS18X20_CACHE_FLAG_TEMP;
+    }
+#else
+    OW_UNUSED(ow);
+    OW_UNUSED(rom_id);
+    OW_UNUSED(raw);
+#endif /* OW_CFG_OS */
+}
+
+/**
+ * \brief           Get highest resolution of devices from cache
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_ids: Array of 1-Wire device addresses
+ * \param[in]       rom_len: Number of devices in array
+ * \return          Highest conversion time resolution in units of bits, `0` if any device is not cached
+ */
+static uint8_t
+prv_cache_resolution(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len) {
+    ow_ds18x20_cache_t* c;
+    uint8_t bits = 0;
+
+    for (size_t i = 0; i < rom_len; ++i) {
+        if (rom_ids[i].rom[0] == 0x10) {
+            bits = 12;                          /* DS18S20 has fixed conversion time of 12-bit resolution */
+        } else if ((c = prv_cache_get(ow, &rom_ids[i], 0)) == NULL || !(c->flags & OW_DS18X20_CACHE_FLAG_CONF)) {
+            return 0;
+        } else if ((((c->conf & 0x60) >> 0x05) + 0x09) > bits) {
+            bits = ((c->conf & 0x60) >> 0x05) + 0x09;
+        }
+    }
+    return bits;
+}
+
+/**
+ * \brief           Read alarm high, alarm low and configuration registers
+ *
+ * Registers are taken from cache when available, otherwise scratchpad is read from the device
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[out]      regs: Output array of `3` bytes for alarm high, alarm low and configuration register
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_read_config(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const regs) {
+    uint8_t data[OW_DS18X20_SCRATCHPAD_LEN];
+    ow_ds18x20_cache_t* c;
+    owr_t res;
+
+    if ((c = prv_cache_get(ow, rom_id, 0)) != NULL && (c->flags & OW_DS18X20_CACHE_FLAG_CONF)) {
+        regs[0] = c->th;
+        regs[1] = c->tl;
+        regs[2] = c->conf;
+        return owOK;
+    }
+    if ((res = prv_read_scratchpad(ow, rom_id, data, sizeof(data))) != owOK) {
+        return res;
+    }
+    if (ow_crc(data, sizeof(data)) != 0) {
+        return owERRCRC;
+    }
+    prv_cache_update(ow, rom_id, data);
+    memcpy(regs, &data[2], 3);
+    return owOK;
+}
+
+/**
+ * \brief           Read power supply mode of the device
+ *
+ * Mode is taken from cache when available, otherwise device is queried
+ * with read power supply command and result is saved to cache.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address. Set to `NULL` to check all devices on the bus
+ * \param[out]      parasitic: Output variable set to `1` when (any) device is parasitically powered
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_read_power(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const parasitic) {
+    ow_ds18x20_cache_t* c;
+    uint8_t bit_val;
+    owr_t res;
+
+    if ((c = prv_cache_get(ow, rom_id, 0)) != NULL && (c->flags & OW_DS18X20_CACHE_FLAG_POWER)) {
+        *parasitic = (c->flags & OW_DS18X20_CACHE_FLAG_PARASITIC) != 0;
+        return owOK;
+    }
+    if ((res = prv_send_cmd(ow, rom_id, OW_CMD_RPWRSUPPLY)) != owOK
+        || (res = ow_read_bit_ex_raw(ow, &bit_val)) != owOK) {
+        return res;
+    }
+    *parasitic = bit_val == 0;                  /* Parasitically powered devices pull line low */
+    if ((c = prv_cache_get(ow, rom_id, 1)) != NULL) {
+        c->flags &= ~OW_DS18X20_CACHE_FLAG_PARASITIC;
+        c->flags |= OW_DS18X20_CACHE_FLAG_POWER | (*parasitic ? OW_DS18X20_CACHE_FLAG_PARASITIC : 0);
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Check if any of listed devices is parasitically powered
+ *
+ * Each device is queried once and its mode is kept in cache.
+ * When devices cannot be cached, all devices on the bus are checked with single query.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_ids: Array of 1-Wire device addresses
+ * \param[in]       rom_len: Number of devices in array
+ * \param[out]      parasitic: Output variable set to `1` when any device is parasitically powered
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_bus_parasitic(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len, uint8_t* const parasitic) {
+    uint8_t p;
+    owr_t res;
+
+    *parasitic = 0;
+    for (size_t i = 0; i < rom_len; ++i) {
+        if (prv_cache_get(ow, &rom_ids[i], 1) == NULL) {
+            return prv_read_power(ow, NULL, parasitic);
+        }
+        if ((res = prv_read_power(ow, &rom_ids[i], &p)) != owOK) {
+            return res;
+        }
+        *parasitic |= p;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Supply parasitically powered devices for complete operation time
+ *
+ * With operating system, line is held high with strong pullup (when supported by low-level driver)
+ * for `ms` milliseconds. Read slots are not used, as they interrupt power supply of the devices.
+ *
+ * Without operating system there is no time base to wait on,
+ * read slots are polled for up to `2x` of operation time instead.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       ms: Maximal operation time in units of milliseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_hold_power(ow_t* const ow, const uint32_t ms) {
+#if OW_CFG_OS
+    uint8_t spu;
+    owr_t res;
+
+    spu = ow_strong_pullup_raw(ow, 1) == owOK;
+    res = ow_delay_raw(ow, ms);
+    if (spu && ow_strong_pullup_raw(ow, 0) != owOK && res == owOK) {
+        res = owERR;                            /* Line must be released even when deadline expired */
+    }
+    return res;
+#else
+    uint8_t done = 0;
+    owr_t res;
+
+    for (uint32_t i = OW_DS18X20_POLL_BYTES(2 * ms); i > 0; --i) {
+        if ((res = prv_check_done(ow, &done)) != owOK || done) {
+            return res;
+        }
+    }
+    return owERR;
+#endif /* OW_CFG_OS */
+}
+
+/**
+ * \brief           Wait for EEPROM write to complete
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       parasitic: Set to `1` when (any) addressed device is parasitically powered
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_wait_copy(ow_t* const ow, const uint8_t parasitic) {
+    uint8_t done = 0;
+    owr_t res;
+
+    if (parasitic) {
+        return prv_hold_power(ow, OW_DS18X20_COPY_TIME);
+    }
+#if OW_CFG_OS
+    if ((res = ow_delay_raw(ow, OW_DS18X20_COPY_TIME)) != owOK) {
+        return res;
+    }
+#endif /* OW_CFG_OS */
+    for (uint32_t i = OW_DS18X20_POLL_BYTES(2 * OW_DS18X20_COPY_TIME); !done && i > 0; --i) {
+        if ((res = prv_check_done(ow, &done)) != owOK) {
+            return res;
+        }
+    }
+    return done ? owOK : owERR;
+}
+
+/**
+ * \brief           Send copy scratchpad command and wait for EEPROM write to complete
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address. Set to `NULL` to copy on all devices
+ * \param[in]       parasitic: Set to `1` when (any) addressed device is parasitically powered
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_copy_scratchpad(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t parasitic) {
+#if OW_CFG_CANCEL
+    ow_cancel_t* cancel;
+#endif /* OW_CFG_CANCEL */
+    owr_t res;
+
+    if ((res = prv_send_cmd(ow, rom_id, OW_CMD_CPYSCRATCHPAD)) != owOK) {
+        return res;
+    }
+#if OW_CFG_CANCEL
+    /* Interrupted EEPROM write corrupts the registers, cancellation is checked after it */
+    cancel = ow->cancel;
+    ow->cancel = NULL;
+#endif /* OW_CFG_CANCEL */
+    res = prv_wait_copy(ow, parasitic);
+#if OW_CFG_CANCEL
+    ow->cancel = cancel;
+#endif /* OW_CFG_CANCEL */
+    return res;
+}
+
+/**
+ * \brief           Write alarm high, alarm low and configuration registers
+ *
+ * Write is skipped completely, when cached registers of the device already hold the same values
+ * (and are already stored to EEPROM, when `persist` is set)
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       regs: Array of `3` bytes for alarm high, alarm low and configuration register
+ * \param[in]       persist: Set to `1` to copy registers to EEPROM, `0` to write scratchpad only
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_write_config(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t* const regs, const uint8_t persist) {
+    ow_ds18x20_cache_t* c;
+    owr_t res;
+
+    if ((c = prv_cache_get(ow, rom_id, 0)) != NULL && (c->flags & OW_DS18X20_CACHE_FLAG_CONF)
+        && c->th == regs[0] && c->tl == regs[1] && c->conf == regs[2]
+        && (!persist || !(c->flags & OW_DS18X20_CACHE_FLAG_DIRTY))) {
+        return owOK;                            /* Device already has the same values */
+    }
+
+    /* Write scratchpad and optionally copy it to non-volatile memory */
+    if ((res = prv_send_cmd(ow, rom_id, OW_CMD_WSCRATCHPAD)) != owOK
+        || (res = ow_write_bytes_ex_raw(ow, regs, NULL, 3)) != owOK
+        || (persist && (res = prv_copy_scratchpad(ow, rom_id, c != NULL && (c->flags & OW_DS18X20_CACHE_FLAG_PARASITIC))) != owOK)) {
+        if (c != NULL) {
+            c->flags &= ~OW_DS18X20_CACHE_FLAG_CONF;    /* Device state is not known anymore */
+        }
+        return res;
+    }
+    if ((c = prv_cache_get(ow, rom_id, 1)) != NULL) {
+        c->th = regs[0];
+        c->tl = regs[1];
+        c->conf = regs[2];
+        c->flags |= OW_DS18X20_CACHE_FLAG_CONF;
+        if (persist) {
+            c->flags &= ~OW_DS18X20_CACHE_FLAG_DIRTY;
+        } else {
+            c->flags |= OW_DS18X20_CACHE_FLAG_DIRTY;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Read scratchpad of single device and fill result record
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to read data from
+ * \param[out]      r: Result record to fill. `status` member is always set
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_read_result(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_result_t* const r) {
+    uint8_t data[OW_DS18X20_SCRATCHPAD_LEN];
+
+    r->status = prv_read_scratchpad(ow, rom_id, data, sizeof(data));
+    if (r->status == owOK && ow_crc(data, sizeof(data)) != 0) {
+        r->status = owERRCRC;
+    }
+    if (r->status == owOK) {
+        prv_cache_update(ow, rom_id, data);
+        r->raw = prv_decode_raw(rom_id, data, &r->resolution);
+        r->mcelsius = OW_DS18X20_RAW_TO_MCELSIUS(r->raw);
+        prv_cache_temp(ow, rom_id, r->raw);
+        r->th = (int8_t)data[2];
+        r->tl = (int8_t)data[3];
+    }
+    return r->status;
+}
+
 /**
  * \brief           Start temperature conversion on specific (or all) devices
  * \param[in]       ow: 1-Wire handle
@@ -47,384 +575,1677 @@ ow_ds18x20_start_raw(ow_t* const ow, const ow_rom_t* const rom_id) {
 
     OW_ASSERT0("ow != NULL", ow != NULL);
 
-    if (ow_reset_raw(ow) == owOK) {
-        if (rom_id == NULL) {                   /* Check for ROM id */
-            ow_skip_rom_raw(ow);                /* Skip ROM, send to all devices */
-        } else {
-            ow_match_rom_raw(ow, rom_id);       /* Select exact device by ROM address */
-        }
-        ow_write_byte_ex_raw(ow, 0x44, NULL);   /* Start temperature conversion */
+    /* Reset and address device(s) with conversion command in single transfer */
+    if (prv_send_cmd(ow, rom_id, OW_DS18X20_CMD_CONVERT) == owOK) {
+        ret = 1;
+    }
+    return ret;
+}
+
+/**
+ * \copydoc         ow_ds18x20_start_raw
+ * \note            This function is thread-safe
+ */
+uint8_t
+ow_ds18x20_start(ow_t* const ow, const ow_rom_t* const rom_id) {
+    uint8_t res;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_start_raw(ow, rom_id);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Read temperature previously started with \ref ow_ds18x20_start, in fixed-point format
+ *
+ * Function fails if conversion is still in progress.
+ * Use \ref ow_ds18x20_wait to wait for conversion to complete, before reading temperature
+ *
+ * \note            Function does not use floating point arithmetic.
+ *                  Use \ref OW_DS18X20_RAW_TO_MCELSIUS to convert result to milli-degrees Celsius
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to read data from
+ * \param[out]      t: Pointer to output variable to save temperature in units of `1/16` degree Celsius
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_ds18x20_read_fixed_raw(ow_t* const ow, const ow_rom_t* const rom_id, int16_t* const t) {
+    uint8_t ret = 0, data[OW_DS18X20_SCRATCHPAD_LEN], bit_val;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("t != NULL", t != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    /*
+     * First read bit and check if all devices completed with conversion.
+     * If everything ready, read scratchpad and check CRC, result must be 0 to match
+     */
+    if (ow_read_bit_ex_raw(ow, &bit_val) == owOK && bit_val != 0
+        && prv_read_scratchpad(ow, rom_id, data, sizeof(data)) == owOK
+        && ow_crc(data, sizeof(data)) == 0) {
+        prv_cache_update(ow, rom_id, data);
+        *t = prv_decode_raw(rom_id, data, NULL);
+        prv_cache_temp(ow, rom_id, *t);
         ret = 1;
     }
     return ret;
 }
 
 /**
- * \copydoc         ow_ds18x20_start_raw
+ * \copydoc         ow_ds18x20_read_fixed_raw
+ * \note            This function is thread-safe
+ */
+uint8_t
+ow_ds18x20_read_fixed(ow_t* const ow, const ow_rom_t* const rom_id, int16_t* const t) {
+    uint8_t res;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("t != NULL", t != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_fixed_raw(ow, rom_id, t);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Read temperature, resolution and alarm levels previously started with \ref ow_ds18x20_start
+ *
+ * All values are decoded from single scratchpad read,
+ * without separate call to \ref ow_ds18x20_get_resolution.
+ * Function fails if conversion is still in progress.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to read data from
+ * \param[out]      result: Pointer to result record. `status` member is set to return value,
+ *                      other members are valid only when it is \ref owOK
+ * \return          \ref owOK on success, \ref owERRCRC on CRC mismatch, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_read_ex_raw(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_result_t* const result) {
+    uint8_t bit_val;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("result != NULL", result != NULL);
+    OW_ASSERT("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    /* Devices hold the line low until conversion completes */
+    if ((result->status = ow_read_bit_ex_raw(ow, &bit_val)) == owOK && bit_val == 0) {
+        result->status = owERR;
+    }
+    if (result->status != owOK) {
+        return result->status;
+    }
+    return prv_read_result(ow, rom_id, result);
+}
+
+/**
+ * \copydoc         ow_ds18x20_read_ex_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_read_ex(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_result_t* const result) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("result != NULL", result != NULL);
+    OW_ASSERT("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_ex_raw(ow, rom_id, result);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+#if (OW_CFG_OS && OW_CFG_DS18X20_CACHE) || __DOXYGEN__
+
+/**
+ * \brief           Read temperature through cache, with maximal age of the reading
+ *
+ * Last reading of the device is returned without bus communication, when it is not older than `max_age_ms`.
+ * Otherwise conversion is started on the device, and new reading is saved to cache.
+ * Readings of other functions, such as \ref ow_ds18x20_read_all, refresh the cache too.
+ *
+ * \note            Device must have an entry in cache attached with \ref ow_ds18x20_cache_attach,
+ *                  otherwise conversion is started on every call
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       max_age_ms: Maximal age of cached reading in units of milliseconds
+ * \param[out]      t: Output variable to save temperature in units of `1/16` degree Celsius
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_read_cached_raw(ow_t* const ow, const ow_rom_t* const rom_id, const uint32_t max_age_ms, int16_t* const t) {
+    ow_ds18x20_cache_t* c;
+    ow_ds18x20_result_t r;
+    uint8_t bits, parasitic;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("t != NULL", t != NULL);
+    OW_ASSERT("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    /* Return last reading when fresh enough */
+    if ((c = prv_cache_get(ow, rom_id, 0)) != NULL && (c->flags & OW_DS18X20_CACHE_FLAG_TEMP)
+        && (ow_sys_get_tick(ow->arg) - c->tick) <= max_age_ms) {
+        *t = c->raw;
+        return owOK;
+    }
+
+    /* Convert on single device and read it */
+    bits = prv_cache_resolution(ow, rom_id, 1);
+    if ((res = prv_bus_parasitic(ow, rom_id, 1, &parasitic)) != owOK
+        || (res = prv_send_cmd(ow, rom_id, OW_DS18X20_CMD_CONVERT)) != owOK) {
+        return res;
+    }
+    if (parasitic) {
+        res = prv_hold_power(ow, OW_DS18X20_CONV_TIME(bits > 0 ? bits : 12));
+    } else {
+        res = ow_ds18x20_wait_raw(ow, bits);
+    }
+    if (res != owOK || (res = prv_read_result(ow, rom_id, &r)) != owOK) {
+        return res;
+    }
+    *t = r.raw;
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_ds18x20_read_cached_raw
+ * \note            This function is thread-safe. Freshness is checked with bus locked,
+ *                  concurrent callers for the same device wait for single reading in progress
+ *                  and return its result, instead of starting their own
+ */
+owr_t
+ow_ds18x20_read_cached(ow_t* const ow, const ow_rom_t* const rom_id, const uint32_t max_age_ms, int16_t* const t) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("t != NULL", t != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_cached_raw(ow, rom_id, max_age_ms, t);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+#endif /* (OW_CFG_OS && OW_CFG_DS18X20_CACHE) || __DOXYGEN__ */
+
+/**
+ * \brief           Read temperature previously started with \ref ow_ds18x20_start
+ *
+ * Function fails if conversion is still in progress.
+ * Use \ref ow_ds18x20_wait to wait for conversion to complete, before reading temperature
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to read data from
+ * \param[out]      t: Pointer to output float variable to save temperature
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_ds18x20_read_raw(ow_t* const ow, const ow_rom_t* const rom_id, float* const t) {
+    int16_t raw;
+    uint8_t ret = 0;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("t != NULL", t != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    if (ow_ds18x20_read_fixed_raw(ow, rom_id, &raw)) {
+        *t = (float)raw / 16.0f;                /* Convert from 1/16 units */
+        ret = 1;
+    }
+    return ret;
+}
+
+/**
+ * \copydoc         ow_ds18x20_read_raw
+ * \note            This function is thread-safe
+ */
+uint8_t
+ow_ds18x20_read(ow_t* const ow, const ow_rom_t* const rom_id, float* const t) {
+    uint8_t res;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("t != NULL", t != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_raw(ow, rom_id, t);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Read first `2` or `5` bytes of scratchpad with temperature and abort the read with reset
+ *
+ * Compared to full scratchpad read of `9` bytes, partial read needs less than half of the bus time,
+ * but CRC byte is not read. Data integrity can be checked with `flags` member of `p` structure:
+ *
+ *  - \ref OW_DS18X20_CHECK_DUPLICATE reads data twice and fails if reads do not match
+ *  - \ref OW_DS18X20_CHECK_PLAUSIBLE fails if temperature changed for more than `max_step` since last accepted value,
+ *      or if it equals `85` degrees power-on value, unless last accepted value is within `max_step` of it.
+ *      Rejected value is still accepted as new baseline, when `confirm` consecutive reads are within `max_step`
+ *      of each other, so real temperature change is not rejected forever.
+ *      Application may also clear `last_valid` member to accept next read as new baseline
+ *
+ * Data of all ones, as read when device does not respond, is rejected regardless of `flags`.
+ * When only temperature is read, this also rejects valid `-1/16` degree reading of `12-bit` resolution.
+ * When temperature is accepted, it is saved as last value to `p` structure.
+ * Resolution is updated when configuration byte is read, and used to clear undefined temperature bits.
+ *
+ * \note            Conversion shall be completed before calling this function, see \ref ow_ds18x20_wait
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to read data from
+ * \param[in,out]   p: Partial read configuration and state
+ * \param[out]      t: Pointer to output variable to save temperature in units of `1/16` degree Celsius
+ * \return          \ref owOK on success, \ref owERR when integrity check failed, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_read_partial_raw(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_partial_t* const p, int16_t* const t) {
+    uint8_t data[OW_DS18X20_SCRATCHPAD_LEN], dup[OW_DS18X20_PARTIAL_CONF];
+    int16_t raw;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("p != NULL", p != NULL);
+    OW_ASSERT("t != NULL", t != NULL);
+    OW_ASSERT("p->len == OW_DS18X20_PARTIAL_TEMP || p->len == OW_DS18X20_PARTIAL_CONF",
+                p->len == OW_DS18X20_PARTIAL_TEMP || p->len == OW_DS18X20_PARTIAL_CONF);
+
+    /* Read data and abort scratchpad read with reset */
+    if ((res = prv_read_scratchpad(ow, rom_id, data, p->len)) != owOK
+        || (res = ow_reset_raw(ow)) != owOK) {
+        return res;
+    }
+    if (p->flags & OW_DS18X20_CHECK_DUPLICATE) {
+        if ((res = prv_read_scratchpad(ow, rom_id, dup, p->len)) != owOK
+            || (res = ow_reset_raw(ow)) != owOK) {
+            return res;
+        }
+        if (memcmp(data, dup, p->len) != 0) {
+            return owERR;
+        }
+    }
+    /* Idle bus reads as all ones and matches itself on duplicate read, bit `7` of configuration byte is always `0` */
+    if (data[0] == 0xFF && data[1] == 0xFF
+        && (p->len == OW_DS18X20_PARTIAL_TEMP || data[4] == 0xFF)) {
+        return owERR;
+    }
+
+    /* Configuration byte has been read or use known resolution */
+    if (p->len == OW_DS18X20_PARTIAL_CONF) {
+        p->resolution = ((data[4] & 0x60) >> 0x05) + 0x09;
+    } else {
+        data[4] = p->resolution >= 9 ? ((p->resolution - 9) << 0x05) : 0x60;
+    }
+    raw = prv_decode_raw(rom_id, data, NULL);
+
+    if (p->flags & OW_DS18X20_CHECK_PLAUSIBLE) {
+        int32_t diff = p->last_valid ? ((int32_t)raw - p->last) : 0;
+
+        if (diff > p->max_step || diff < -p->max_step
+            || (raw == OW_DS18X20_POWER_ON_RAW && !p->last_valid)) {
+            /* Track rejected value, accept it once consecutive reads confirm it */
+            diff = (int32_t)raw - p->cand;
+            if (p->cand_count > 0 && diff <= p->max_step && diff >= -p->max_step) {
+                ++p->cand_count;
+            } else {
+                p->cand_count = 1;
+            }
+            p->cand = raw;
+            if (p->cand_count < (p->confirm > 0 ? p->confirm : OW_DS18X20_PARTIAL_CONFIRM)) {
+                return owERR;
+            }
+        }
+    }
+    p->cand_count = 0;
+    p->last = raw;
+    p->last_valid = 1;
+    *t = raw;
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_ds18x20_read_partial_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_read_partial(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_partial_t* const p, int16_t* const t) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("p != NULL", p != NULL);
+    OW_ASSERT("t != NULL", t != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_partial_raw(ow, rom_id, p, t);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Get highest resolution, which conversion fits to sample period
+ *
+ * Time to read all devices on the bus once per period is subtracted from the period,
+ * remaining time is available for temperature conversion.
+ *
+ * \param[in]       period_ms: Target sample period of each device in units of milliseconds
+ * \param[in]       rom_len: Number of devices sampled on the bus
+ * \return          Resolution in units of bits (`9 - 12`). `9` is returned when even `9-bit` conversion does not fit
+ * \note            This function is reentrant
+ */
+uint8_t
+ow_ds18x20_period_to_bits(const uint32_t period_ms, const size_t rom_len) {
+    uint32_t read_ms, budget;
+    uint8_t bits;
+
+    read_ms = (uint32_t)((rom_len * ow_get_transfer_time(1, OW_DS18X20_READ_BYTES) + 999) / 1000);
+    budget = period_ms > read_ms ? period_ms - read_ms : 0;
+    for (bits = 12; bits > 9 && OW_DS18X20_CONV_TIME(bits) > budget; --bits) {}
+    return bits;
+}
+
+/**
+ * \brief           Get bus time used by single sample of the device
+ *
+ * Sample consists of conversion start and scratchpad read, each with reset and `MATCH ROM` command.
+ * Parasitically powered device additionally occupies the bus for complete conversion time,
+ * while it is supplied with strong pullup.
+ *
+ * \param[in]       req: Sampling request of the device
+ * \return          Bus time in units of microseconds
+ */
+static uint32_t
+prv_plan_sample_time(const ow_ds18x20_plan_req_t* const req) {
+    uint32_t t;
+
+    t = ow_get_transfer_time(2, OW_DS18X20_START_BYTES + OW_DS18X20_READ_BYTES);
+    if (req->parasitic) {
+        t += OW_DS18X20_CONV_TIME(req->resolution) * 1000;
+    }
+    return t;
+}
+
+/**
+ * \brief           Initialize bus capacity plan with no devices
+ * \param[out]      plan: Plan handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_plan_init(ow_ds18x20_plan_t* const plan) {
+    OW_ASSERT("plan != NULL", plan != NULL);
+
+    memset(plan, 0x00, sizeof(*plan));
+    return owOK;
+}
+
+/**
+ * \brief           Admit devices to bus capacity plan
+ *
+ * Bus time of each sample is calculated from UART byte costs of reset, `MATCH ROM`,
+ * conversion start and scratchpad read with \ref ow_get_transfer_time.
+ * Devices are admitted only when all of them fit: sample period of each device
+ * covers its conversion time and bus time of all admitted devices does not exceed `1` second per second.
+ * Plan is not modified when request is rejected.
+ *
+ * \code{c}
+ow_ds18x20_plan_t plan;
+ow_ds18x20_plan_req_t req = { .resolution = 12, .parasitic = 0, .period_ms = 1000 };
+
+ow_ds18x20_plan_init(&plan);
+if (ow_ds18x20_plan_add(&plan, &req, 1) != owOK) {
+    //Bus is oversubscribed, request rejected
+}
+\endcode
+ *
+ * \param[in,out]   plan: Plan handle
+ * \param[in]       reqs: Array of sampling requests, one for each device
+ * \param[in]       len: Number of entries in `reqs` array
+ * \return          \ref owOK when devices are admitted, \ref owERR when they would overload the bus,
+ *                      member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_plan_add(ow_ds18x20_plan_t* const plan, const ow_ds18x20_plan_req_t* const reqs, const size_t len) {
+    uint64_t load = 0, rate = 0;
+    uint32_t t, min_us;
+
+    OW_ASSERT("plan != NULL", plan != NULL);
+    OW_ASSERT("reqs != NULL", reqs != NULL);
+
+    for (size_t i = 0; i < len; ++i) {
+        OW_ASSERT("reqs[i].resolution >= 9 && reqs[i].resolution <= 12", reqs[i].resolution >= 9 && reqs[i].resolution <= 12);
+        OW_ASSERT("reqs[i].period_ms > 0", reqs[i].period_ms > 0);
+
+        /* Conversion and its bus transfers must complete within the period */
+        t = prv_plan_sample_time(&reqs[i]);
+        min_us = reqs[i].parasitic ? t : t + OW_DS18X20_CONV_TIME(reqs[i].resolution) * 1000;
+        if ((uint64_t)reqs[i].period_ms * 1000 < min_us) {
+            return owERR;
+        }
+        load += ((uint64_t)t * 1000 + reqs[i].period_ms - 1) / reqs[i].period_ms;
+        rate += 1000000UL / reqs[i].period_ms;
+    }
+    if (plan->load_us + load > 1000000UL) {
+        return owERR;
+    }
+    plan->load_us += (uint32_t)load;
+    plan->rate_mhz += (uint32_t)rate;
+    plan->count += len;
+    return owOK;
+}
+
+/**
+ * \brief           Remove devices from bus capacity plan
+ * \param[in,out]   plan: Plan handle
+ * \param[in]       reqs: Array of sampling requests, previously admitted with \ref ow_ds18x20_plan_add
+ * \param[in]       len: Number of entries in `reqs` array
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_plan_remove(ow_ds18x20_plan_t* const plan, const ow_ds18x20_plan_req_t* const reqs, const size_t len) {
+    uint32_t load;
+
+    OW_ASSERT("plan != NULL", plan != NULL);
+    OW_ASSERT("reqs != NULL", reqs != NULL);
+    OW_ASSERT("len <= plan->count", len <= plan->count);
+
+    for (size_t i = 0; i < len; ++i) {
+        OW_ASSERT("reqs[i].period_ms > 0", reqs[i].period_ms > 0);
+
+        load = (uint32_t)(((uint64_t)prv_plan_sample_time(&reqs[i]) * 1000 + reqs[i].period_ms - 1) / reqs[i].period_ms);
+        plan->load_us -= load < plan->load_us ? load : plan->load_us;
+        plan->rate_mhz -= 1000000UL / reqs[i].period_ms < plan->rate_mhz ? 1000000UL / reqs[i].period_ms : plan->rate_mhz;
+    }
+    plan->count -= len;
+    return owOK;
+}
+
+/**
+ * \brief           Get unused bus capacity of the plan
+ * \param[in]       plan: Plan handle
+ * \return          Unused part of bus time, between `0` (fully loaded) and `1` (idle)
+ * \note            This function is reentrant
+ */
+float
+ow_ds18x20_plan_get_headroom(const ow_ds18x20_plan_t* const plan) {
+    OW_ASSERT0("plan != NULL", plan != NULL);
+
+    return 1.0f - (float)plan->load_us / 1000000.0f;
+}
+
+/**
+ * \brief           Get highest total sample rate of the plan
+ *
+ * Sample periods of all admitted devices are shortened by the same factor,
+ * until bus time is fully used. Conversion time limits of each device are not considered.
+ *
+ * \param[in]       plan: Plan handle
+ * \return          Achievable number of samples per second, `0` when plan is empty
+ * \note            This function is reentrant
+ */
+float
+ow_ds18x20_plan_get_max_rate(const ow_ds18x20_plan_t* const plan) {
+    OW_ASSERT0("plan != NULL", plan != NULL);
+
+    if (plan->load_us == 0) {
+        return 0.0f;
+    }
+    return (float)plan->rate_mhz / 1000.0f * 1000000.0f / (float)plan->load_us;
+}
+
+/**
+ * \brief           Adapt resolution of each `DS18B20` device to its target sample period
+ *
+ * Highest resolution that fits the period is selected for each device with \ref ow_ds18x20_period_to_bits.
+ * New resolution is written to scratchpad only, without EEPROM copy, and only when it differs from
+ * current resolution. Current setting is kept in cache, repeated calls with unchanged periods
+ * do not communicate on the bus.
+ *
+ * Short periods select fast low-resolution conversions during transients,
+ * long periods restore full precision in steady state.
+ *
+ * \note            Resolution written by this function is lost on device power cycle.
+ *                  Use \ref ow_ds18x20_set_resolution to make it permanent
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_ids: Array of 1-Wire device addresses. `DS18S20` devices are ignored
+ * \param[in]       rom_len: Number of entries in `rom_ids` and `periods` arrays
+ * \param[in]       periods: Target sample period of each device in units of milliseconds
+ * \param[out]      changed: Output variable to save number of devices with changed resolution. Set to `NULL` if not used
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_adapt_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len,
+                                const uint32_t* const periods, size_t* const changed) {
+    uint8_t regs[3], conf;
+    size_t cnt = 0;
+    owr_t res = owOK;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("rom_ids != NULL", rom_ids != NULL);
+    OW_ASSERT("rom_len > 0", rom_len > 0);
+    OW_ASSERT("periods != NULL", periods != NULL);
+
+    for (size_t i = 0; i < rom_len; ++i) {
+        if (!ow_ds18x20_is_b(ow, &rom_ids[i])) {
+            continue;
+        }
+        if ((res = prv_read_config(ow, &rom_ids[i], regs)) != owOK) {
+            break;
+        }
+        conf = (uint8_t)((regs[2] & ~0x60) | ((ow_ds18x20_period_to_bits(periods[i], rom_len) - 9) << 0x05));
+        if (conf != regs[2]) {
+            regs[2] = conf;
+            if ((res = prv_write_config(ow, &rom_ids[i], regs, 0)) != owOK) {
+                break;
+            }
+            ++cnt;
+        }
+    }
+    if (changed != NULL) {
+        *changed = cnt;
+    }
+    return res;
+}
+
+/**
+ * \copydoc         ow_ds18x20_adapt_resolution_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_adapt_resolution(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len,
+                            const uint32_t* const periods, size_t* const changed) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_adapt_resolution_raw(ow, rom_ids, rom_len, periods, changed);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Get resolution for `DS18B20` device
+ * \note            When device is in the cache, resolution is returned without bus communication
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to get resolution from
+ * \return          Resolution in units of bits (`9 - 12`) on success, `0` otherwise
+ */
+uint8_t
+ow_ds18x20_get_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_id) {
+    uint8_t res = 0, regs[3];
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("rom_id != NULL", rom_id != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+
+    if (prv_read_config(ow, rom_id, regs) == owOK) {
+        res = ((regs[2] & 0x60) >> 0x05) + 9;   /* Calculate bits from configuration byte */
+    }
+    return res;
+}
+
+/**
+ * \copydoc         ow_ds18x20_get_resolution_raw
+ * \note            This function is thread-safe
+ */
+uint8_t
+ow_ds18x20_get_resolution(ow_t* const ow, const ow_rom_t* const rom_id) {
+    uint8_t res;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("rom_id != NULL", rom_id != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_get_resolution_raw(ow, rom_id);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Set resolution for `DS18B20` sensor
+ *
+ * When device is in the cache, scratchpad is not read before write,
+ * and nothing is written when resolution is already set to the same value
+ *
+ * \note            `DS18S20` has fixed `9-bit` resolution
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address to set resolution
+ * \param[in]       bits: Number of resolution bits. Possible values are `9 - 12`
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_ds18x20_set_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t bits) {
+    uint8_t regs[3], res = 0;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("bits >= 9 && bits <= 12", bits >= 9 && bits <= 12);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+
+    if (prv_read_config(ow, rom_id, regs) == owOK) {
+        regs[2] &= ~0x60;                       /* Remove configuration bits for temperature resolution */
+        regs[2] |= (bits - 9) << 0x05;          /* Set new resolution bits */
+        res = prv_write_config(ow, rom_id, regs, 1) == owOK;
+    }
+    return res;
+}
+
+/**
+ * \copydoc         ow_ds18x20_set_resolution_raw
+ * \note            This function is thread-safe
+ */
+uint8_t
+ow_ds18x20_set_resolution(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t bits) {
+    uint8_t res;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("bits >= 9 && bits <= 12", bits >= 9 && bits <= 12);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_set_resolution_raw(ow, rom_id, bits);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Set/clear temperature alarm high/low levels in units of degree Celcius
+ *
+ * When device is in the cache, scratchpad is not read before write,
+ * and nothing is written when alarm levels are already set to the same values
+ *
+ * \note            `temp_h` and `temp_l` are high and low temperature alarms and can accept different values:
+ *                      - `-55 % 125`, valid temperature range
+ *                      - \ref OW_DS18X20_ALARM_DISABLE to disable temperature alarm (either high or low)
+ *                      - \ref OW_DS18X20_ALARM_NOCHANGE to keep current alarm temperature (either high or low)
+ *
+ * Example usage would look something similar to:
+ * \code{c}
+//Set alarm temperature; low = 10°C, high = 30°C
+ow_ds18x20_set_alarm_temp(&ow, dev_id, 10, 30);
+//Set alarm temperature; low = disable, high = no change
+ow_ds18x20_set_alarm_temp(&ow, dev_id, OW_DS18X20_ALARM_DISABLE, OW_DS18X20_ALARM_NOCHANGE);
+//Set alarm temperature; low = no change, high = disable
+ow_ds18x20_set_alarm_temp(&ow, dev_id, OW_DS18X20_ALARM_NOCHANGE, OW_DS18X20_ALARM_DISABLE);
+//Set alarm temperature; low = 10°C, high = 30°C
+ow_ds18x20_set_alarm_temp(&ow, dev_id, 10, 30);
+\endcode
+ *
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       temp_l: Alarm low temperature
+ * \param[in]       temp_h: Alarm high temperature
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_ds18x20_set_alarm_temp_raw(ow_t* const ow, const ow_rom_t* const rom_id, int8_t temp_l, int8_t temp_h) {
+    uint8_t res = 0, regs[3];
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+
+    /* Check if there is need to do anything */
+    if (temp_l == OW_DS18X20_ALARM_NOCHANGE && temp_h == OW_DS18X20_ALARM_NOCHANGE) {
+        return 1;
+    }
+
+    if (prv_read_config(ow, rom_id, regs) == owOK) {
+        /* Fill new values, limited to valid temperature range */
+        if (temp_h != OW_DS18X20_ALARM_NOCHANGE) {
+            regs[0] = (uint8_t)prv_alarm_level(temp_h, OW_DS18X20_TEMP_MAX);
+        }
+        if (temp_l != OW_DS18X20_ALARM_NOCHANGE) {
+            regs[1] = (uint8_t)prv_alarm_level(temp_l, OW_DS18X20_TEMP_MIN);
+        }
+        res = prv_write_config(ow, rom_id, regs, 1) == owOK;
+    }
+    return res;
+}
+
+/**
+ * \copydoc         ow_ds18x20_set_alarm_temp_raw
+ * \note            This function is thread-safe
+ */
+uint8_t
+ow_ds18x20_set_alarm_temp(ow_t* const ow, const ow_rom_t* const rom_id, int8_t temp_l, int8_t temp_h) {
+    uint8_t res;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_set_alarm_temp_raw(ow, rom_id, temp_l, temp_h);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Wait for temperature conversion to complete on all devices
+ *
+ * Function shall be called directly after \ref ow_ds18x20_start_raw,
+ * without any other 1-Wire communication in-between.
+ *
+ * When operating system is used, thread sleeps with \ref ow_delay_raw for half of
+ * the maximal conversion time for `bits` resolution, then continues to poll read slots
+ * in steps of `1/16` of maximal conversion time, until all devices release the line.
+ * When `bits` is set to `0`, steps start with `9-bit` conversion time
+ * and increase each time elapsed time exceeds conversion time of current resolution.
+ *
+ * Without operating system, read slots are polled continuously.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       bits: Highest resolution of converting devices in units of bits (`9 - 12`),
+ *                      or `0` when not known
+ * \return          \ref owOK on success, \ref owERR when conversion did not complete
+ *                      within `2x` of maximal conversion time, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_wait_raw(ow_t* const ow, const uint8_t bits) {
+    uint32_t timeout;
+    uint8_t done = 0;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("bits == 0 || (bits >= 9 && bits <= 12)", bits == 0 || (bits >= 9 && bits <= 12));
+
+    timeout = 2 * OW_DS18X20_CONV_TIME(bits > 0 ? bits : 12);
+#if OW_CFG_OS
+    {
+        uint32_t elapsed = 0, delay;
+        uint8_t b = bits > 0 ? bits : 9;
+
+        for (delay = OW_DS18X20_CONV_TIME(b) / 2; elapsed < timeout; ) {
+            if ((res = ow_delay_raw(ow, delay)) != owOK) {
+                return res;
+            }
+            elapsed += delay;
+            if ((res = prv_check_done(ow, &done)) != owOK || done) {
+                return res;
+            }
+
+            /* Unknown resolution, move to next one when its conversion time expired */
+            if (bits == 0 && b < 12 && elapsed >= OW_DS18X20_CONV_TIME(b)) {
+                ++b;
+            }
+            delay = OW_DS18X20_CONV_TIME(b) / 16;
+        }
+    }
+#else
+    for (uint32_t i = OW_DS18X20_POLL_BYTES(timeout); i > 0; --i) {
+        if ((res = prv_check_done(ow, &done)) != owOK || done) {
+            return res;
+        }
+    }
+#endif /* OW_CFG_OS */
+    return owERR;
+}
+
+/**
+ * \copydoc         ow_ds18x20_wait_raw
+ * \note            This function is thread-safe. Bus is locked while waiting
+ */
+owr_t
+ow_ds18x20_wait(ow_t* const ow, const uint8_t bits) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_wait_raw(ow, bits);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Start temperature conversion on all devices and wait to complete
+ *
+ * Conversion is started once for all devices on the bus with `SKIP ROM` command.
+ * When all listed devices are externally powered, \ref ow_ds18x20_wait_raw polls for conversion to complete.
+ * When any device is parasitically powered, line is held high with strong pullup for maximal conversion time instead.
+ * Power supply mode of each device is read once and kept in cache.
+ *
+ * \note            `rom_ids` shall list all devices on the bus, to detect parasitically powered devices reliably
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_ids: Array of 1-Wire device addresses on the bus
+ * \param[in]       rom_len: Number of entries in `rom_ids` array
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_convert_raw(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len) {
+    uint8_t bits, parasitic;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("rom_ids != NULL", rom_ids != NULL);
+    OW_ASSERT("rom_len > 0", rom_len > 0);
+
+    /* Start conversion on all devices at the same time */
+    bits = prv_cache_resolution(ow, rom_ids, rom_len);
+    if ((res = prv_bus_parasitic(ow, rom_ids, rom_len, &parasitic)) != owOK
+        || (res = prv_send_cmd(ow, NULL, OW_DS18X20_CMD_CONVERT)) != owOK) {
+        return res;
+    }
+
+    /* Parasitically powered devices cannot signal completion, wait for maximal time */
+    if (parasitic) {
+        return prv_hold_power(ow, OW_DS18X20_CONV_TIME(bits > 0 ? bits : 12));
+    }
+    return ow_ds18x20_wait_raw(ow, bits);
+}
+
+/**
+ * \copydoc         ow_ds18x20_convert_raw
+ * \note            This function is thread-safe. Bus is locked for complete operation
+ */
+owr_t
+ow_ds18x20_convert(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_convert_raw(ow, rom_ids, rom_len);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Start temperature conversion on all devices and read temperature of listed devices
+ *
+ * Conversion is started and completed with \ref ow_ds18x20_convert_raw.
+ * Afterwards, scratchpad of every listed device is read with batched transfers.
+ *
+ * \note            `rom_ids` shall list all devices on the bus, to detect parasitically powered devices reliably
+ *
+ * Function returns \ref owOK when conversion has been completed,
+ * each device read status is saved to `status` member of its result entry.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_ids: Array of 1-Wire device addresses to read data from
+ * \param[in]       rom_len: Number of entries in `rom_ids` and `results` arrays
+ * \param[out]      results: Array to save results to, one entry for each device in `rom_ids`
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_read_all_raw(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len, ow_ds18x20_result_t* const results) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("rom_ids != NULL", rom_ids != NULL);
+    OW_ASSERT("rom_len > 0", rom_len > 0);
+    OW_ASSERT("results != NULL", results != NULL);
+
+    if ((res = ow_ds18x20_convert_raw(ow, rom_ids, rom_len)) != owOK) {
+        return res;
+    }
+
+    /* Read scratchpad of each device */
+    for (size_t i = 0; i < rom_len; ++i) {
+        prv_read_result(ow, &rom_ids[i], &results[i]);
+    }
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_ds18x20_read_all_raw
+ * \note            This function is thread-safe. Bus is locked for complete operation
+ */
+owr_t
+ow_ds18x20_read_all(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len, ow_ds18x20_result_t* const results) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("rom_ids != NULL", rom_ids != NULL);
+    OW_ASSERT("rom_len > 0", rom_len > 0);
+    OW_ASSERT("results != NULL", results != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_all_raw(ow, rom_ids, rom_len, results);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Decode array of `DS18B20` scratchpads to temperatures in milli-degrees Celsius
+ *
+ * Decoding is branch-free and uses integer arithmetic only. Undefined bits for lower resolutions
+ * are cleared with mask calculated from configuration register, instead of switch statement.
+ * There are no data dependencies between entries.
+ *
+ * \note            Function does not check CRC of the data. It shall be checked
+ *                  with \ref ow_crc when scratchpad has been read from the device
+ * \note            `DS18S20` scratchpads have different format and cannot be decoded by this function
+ *
+ * \param[in]       data: Array of `count` scratchpads, `9` bytes each, stored one after another
+ * \param[in]       count: Number of scratchpads to decode
+ * \param[out]      mcelsius: Output array of `count` temperatures in units of milli-degrees Celsius
+ * \note            This function is reentrant
+ */
+void
+ow_ds18x20_decode_batch(const uint8_t* const data, const size_t count, int32_t* const mcelsius) {
+    if (data == NULL || mcelsius == NULL) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t* d = &data[i * OW_DS18X20_SCRATCHPAD_LEN];
+        int32_t raw = (int16_t)((d[1] << 0x08) | d[0]);
+
+        mcelsius[i] = OW_DS18X20_RAW_TO_MCELSIUS(raw & OW_DS18X20_RES_MASK(d[4]));
+    }
+}
+
+/**
+ * \brief           Configure resolution and alarm levels on all devices on the bus at the same time
+ *
+ * Scratchpad is written and copied to EEPROM with `SKIP ROM` command,
+ * requiring single write and single EEPROM wait regardless of number of devices.
+ * `DS18S20` devices accept alarm levels only, resolution is ignored.
+ *
+ * When `rom_ids` is provided, scratchpad of each listed device is read back afterwards
+ * to verify configuration, and power supply mode of listed devices selects EEPROM wait strategy.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       bits: Number of resolution bits. Possible values are `9 - 12`
+ * \param[in]       temp_l: Alarm low temperature, or \ref OW_DS18X20_ALARM_DISABLE
+ * \param[in]       temp_h: Alarm high temperature, or \ref OW_DS18X20_ALARM_DISABLE
+ * \param[in]       rom_ids: Array of 1-Wire device addresses to verify. Set to `NULL` to skip verification
+ * \param[in]       rom_len: Number of entries in `rom_ids` array
+ * \return          \ref owOK on success, \ref owERR if any device does not hold new configuration,
+ *                      member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_broadcast_config_raw(ow_t* const ow, const uint8_t bits, const int8_t temp_l, const int8_t temp_h,
+                                const ow_rom_t* const rom_ids, const size_t rom_len) {
+    uint8_t regs[3], data[OW_DS18X20_SCRATCHPAD_LEN], parasitic;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("bits >= 9 && bits <= 12", bits >= 9 && bits <= 12);
+    OW_ASSERT("temp_l != OW_DS18X20_ALARM_NOCHANGE", temp_l != OW_DS18X20_ALARM_NOCHANGE);
+    OW_ASSERT("temp_h != OW_DS18X20_ALARM_NOCHANGE", temp_h != OW_DS18X20_ALARM_NOCHANGE);
+    OW_ASSERT("rom_ids == NULL || rom_len > 0", rom_ids == NULL || rom_len > 0);
+
+    regs[0] = (uint8_t)prv_alarm_level(temp_h, OW_DS18X20_TEMP_MAX);
+    regs[1] = (uint8_t)prv_alarm_level(temp_l, OW_DS18X20_TEMP_MIN);
+    regs[2] = (uint8_t)(((bits - 9) << 0x05) | 0x1F);  /* Lower bits always read as 1 */
+
+    /* Check power supply mode, listed devices from cache or all devices at once */
+    if (rom_ids != NULL) {
+        res = prv_bus_parasitic(ow, rom_ids, rom_len, &parasitic);
+    } else {
+        res = prv_read_power(ow, NULL, &parasitic);
+    }
+    if (res != owOK) {
+        return res;
+    }
+
+    /* Write and copy scratchpad on all devices */
+    prv_cache_forget_config(ow);
+    if ((res = prv_send_cmd(ow, NULL, OW_CMD_WSCRATCHPAD)) != owOK
+        || (res = ow_write_bytes_ex_raw(ow, regs, NULL, sizeof(regs))) != owOK
+        || (res = prv_copy_scratchpad(ow, NULL, parasitic)) != owOK) {
+        return res;
+    }
+
+    /* Read back configuration of each listed device */
+    for (size_t i = 0; rom_ids != NULL && i < rom_len; ++i) {
+        if ((res = prv_read_scratchpad(ow, &rom_ids[i], data, sizeof(data))) != owOK) {
+            return res;
+        }
+        if (ow_crc(data, sizeof(data)) != 0) {
+            return owERRCRC;
+        }
+        prv_cache_update(ow, &rom_ids[i], data);
+        if (data[2] != regs[0] || data[3] != regs[1]
+            || (rom_ids[i].rom[0] != 0x10 && data[4] != regs[2])) {
+            return owERR;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_ds18x20_broadcast_config_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_broadcast_config(ow_t* const ow, const uint8_t bits, const int8_t temp_l, const int8_t temp_h,
+                            const ow_rom_t* const rom_ids, const size_t rom_len) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_broadcast_config_raw(ow, bits, temp_l, temp_h, rom_ids, rom_len);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Check if device is parasitically powered
+ *
+ * When device is in the cache, result is returned without bus communication.
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address. Set to `NULL` to check if any device on the bus is parasitically powered
+ * \param[out]      parasitic: Output variable set to `1` when device is parasitically powered, `0` when externally powered
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_read_power_raw(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const parasitic) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("parasitic != NULL", parasitic != NULL);
+
+    return prv_read_power(ow, rom_id, parasitic);
+}
+
+/**
+ * \copydoc         ow_ds18x20_read_power_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_read_power(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const parasitic) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("parasitic != NULL", parasitic != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_ds18x20_read_power_raw(ow, rom_id, parasitic);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+#if OW_CFG_DS18X20_CACHE || __DOXYGEN__
+
+/**
+ * \brief           Attach per-device cache to 1-Wire instance
+ *
+ * Entries are filled when driver reads scratchpad of the device,
+ * to keep alarm and configuration registers in memory. Configuration functions
+ * then skip reading scratchpad before write and skip write when values are unchanged.
+ *
+ * \note            Cache assumes devices are configured only through this driver.
+ *                  Use \ref ow_ds18x20_cache_invalidate if device has been changed externally
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       entries: Array of cache entries. Set to `NULL` to detach cache
+ * \param[in]       len: Number of entries in array
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_cache_attach(ow_t* const ow, ow_ds18x20_cache_t* const entries, const size_t len) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("entries == NULL || len > 0", entries == NULL || len > 0);
+
+    if (entries != NULL) {
+        memset(entries, 0x00, sizeof(*entries) * len);
+    }
+    ow_protect(ow, 1);
+    ow->ds18x20_cache = entries;
+    ow->ds18x20_cache_len = entries != NULL ? len : 0;
+    ow_unprotect(ow, 1);
+    return owOK;
+}
+
+/**
+ * \brief           Invalidate cached data of the device
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address. Set to `NULL` to invalidate all devices
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_ds18x20_cache_invalidate(ow_t* const ow, const ow_rom_t* const rom_id) {
+    ow_ds18x20_cache_t* c;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    if (rom_id == NULL) {
+        c = ow->ds18x20_cache;
+        for (size_t i = 0; i < ow->ds18x20_cache_len; ++i) {
+            c[i].flags = 0;
+        }
+    } else if ((c = prv_cache_get(ow, rom_id, 0)) != NULL) {
+        c->flags = 0;
+    }
+    ow_unprotect(ow, 1);
+    return owOK;
+}
+
+#endif /* OW_CFG_DS18X20_CACHE || __DOXYGEN__ */
+
+/**
+ * \brief           Search for `DS18x20` devices with alarm flag
+ * \note            To reset search, use \ref ow_search_reset function
+ * \param[in]       ow: 1-Wire handle
+ * \param[out]      rom_id: Pointer to 8-byte long variable to save ROM
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_search_alarm_raw(ow_t* const ow, ow_rom_t* const rom_id) {
+    return ow_search_with_command_raw(ow, OW_DS18X20_CMD_ALARM_SEARCH, rom_id);
+}
+
+/**
+ * \copydoc         ow_ds18x20_search_alarm_raw
  * \note            This function is thread-safe
  */
-uint8_t
-ow_ds18x20_start(ow_t* const ow, const ow_rom_t* const rom_id) {
-    uint8_t res;
+owr_t
+ow_ds18x20_search_alarm(ow_t* const ow, ow_rom_t* const rom_id) {
+    owr_t res;
 
-    OW_ASSERT0("ow != NULL", ow != NULL);
+    OW_ASSERT("ow != NULL", ow != NULL);
 
     ow_protect(ow, 1);
-    res = ow_ds18x20_start_raw(ow, rom_id);
+    res = ow_ds18x20_search_alarm_raw(ow, rom_id);
     ow_unprotect(ow, 1);
     return res;
 }
 
 /**
- * \brief           Read temperature previously started with \ref ow_ds18x20_start
+ * \brief           Run one cycle of alarm-driven monitoring
+ *
+ * Temperature conversion is started on all devices at the same time, followed by alarm search.
+ * Only devices with temperature outside of their `TL - TH` band respond to the search,
+ * and only their scratchpad is read. All other devices are within band,
+ * without any per-device bus communication.
+ *
+ * Bus time of each cycle therefore depends on number of devices in alarm state,
+ * not on total number of devices on the bus.
+ *
+ * \note            Alarm levels shall be configured before, for example with \ref ow_ds18x20_broadcast_config
  * \param[in]       ow: 1-Wire handle
- * \param[in]       rom_id: 1-Wire device address to read data from
- * \param[out]      t: Pointer to output float variable to save temperature
- * \return          `1` on success, `0` otherwise
+ * \param[out]      alarm_ids: Array to save addresses of devices in alarm state
+ * \param[out]      results: Array to save readings of devices in alarm state, one entry for each entry in `alarm_ids`
+ * \param[in]       len: Number of entries in `alarm_ids` and `results` arrays.
+ *                      Search stops when array is full
+ * \param[out]      alarms_found: Output variable to save number of devices in alarm state
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
  */
-uint8_t
-ow_ds18x20_read_raw(ow_t* const ow, const ow_rom_t* const rom_id, float* const t) {
-    float dec;
-    uint16_t temp;
-    uint8_t ret = 0, data[9], crc, resolution, m = 0, bit_val;
-    int8_t digit;
+owr_t
+ow_ds18x20_monitor_raw(ow_t* const ow, ow_rom_t* const alarm_ids, ow_ds18x20_result_t* const results,
+                       const size_t len, size_t* const alarms_found) {
+    uint8_t parasitic;
+    size_t cnt = 0;
+    owr_t res;
 
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("t != NULL", t != NULL);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("alarm_ids != NULL", alarm_ids != NULL);
+    OW_ASSERT("results != NULL", results != NULL);
+    OW_ASSERT("len > 0", len > 0);
+    OW_ASSERT("alarms_found != NULL", alarms_found != NULL);
 
-    /*
-     * First read bit and check if all devices completed with conversion.
-     * If everything ready, try to reset the network and continue
-     */
-    if (ow_read_bit_ex_raw(ow, &bit_val) == owOK && bit_val != 0 && ow_reset_raw(ow) == owOK) {
-        if (rom_id == NULL) {                   /* Check for ROM id */
-            ow_skip_rom_raw(ow);                /* Skip ROM, send to all devices */
-        } else {
-            ow_match_rom_raw(ow, rom_id);       /* Select exact device by ROM address */
-        }
-        ow_write_byte_ex_raw(ow, OW_CMD_RSCRATCHPAD, NULL); /* Send command to read scratchpad */
+    *alarms_found = 0;
 
-        /* Read plain data from device */
-        for (uint8_t i = 0; i < 9; ++i) {
-            ow_read_byte_ex_raw(ow, &data[i]);  /* Read byte */
-        }
-        crc = ow_crc(data, 0x09);               /* Calculate CRC */
-        if (crc == 0) {                         /* Result must be 0 to match the CRC */
-            temp = (data[1] << 0x08) | data[0]; /* Format data in integer format */
-            resolution = ((data[4] & 0x60) >> 0x05) + 0x09; /* Set resolution in units of bits */
-            if (temp & 0x8000) {                /* Check for negative temperature */
-                temp = ~temp + 1;               /* Perform two's complement */
-                m = 1;
-            }
-            digit = (temp >> 0x04) | (((temp >> 0x08) & 0x07) << 0x04);
-            switch (resolution) {               /* Check for resolution settings */
-                case 9:  dec = ((temp >> 0x03) & 0x01) * 0.5f; break;
-                case 10: dec = ((temp >> 0x02) & 0x03) * 0.25f; break;
-                case 11: dec = ((temp >> 0x01) & 0x07) * 0.125f; break;
-                case 12: dec = (temp & 0x0F) * 0.0625f; break;
-                default: dec = 0xFF, digit = 0;
-            }
-            dec += digit;
-            if (m) {
-                dec = -dec;
-            }
-            *t = dec;
-            ret = 1;
-        }
+    /* Start conversion on all devices and wait to complete */
+    if ((res = prv_read_power(ow, NULL, &parasitic)) != owOK
+        || (res = prv_send_cmd(ow, NULL, OW_DS18X20_CMD_CONVERT)) != owOK) {
+        return res;
+    }
+    if (parasitic) {
+        res = prv_hold_power(ow, OW_DS18X20_CONV_TIME(12));
+    } else {
+        res = ow_ds18x20_wait_raw(ow, 0);
+    }
+    if (res != owOK) {
+        return res;
     }
 
-    return ret;
+    /* Find devices with alarm flag set after conversion */
+    res = ow_search_devices_with_command_raw(ow, OW_DS18X20_CMD_ALARM_SEARCH, alarm_ids, len, &cnt);
+    if (res != owOK && res != owERRNODEV) {
+        return res;
+    }
+
+    /* Read only devices out of band */
+    for (size_t i = 0; i < cnt; ++i) {
+        prv_read_result(ow, &alarm_ids[i], &results[i]);
+    }
+    *alarms_found = cnt;
+    return owOK;
 }
 
 /**
- * \copydoc         ow_ds18x20_read_raw
- * \note            This function is thread-safe
+ * \copydoc         ow_ds18x20_monitor_raw
+ * \note            This function is thread-safe. Bus is locked for complete cycle
  */
-uint8_t
-ow_ds18x20_read(ow_t* const ow, const ow_rom_t* const rom_id, float* const t) {
-    uint8_t res;
+owr_t
+ow_ds18x20_monitor(ow_t* const ow, ow_rom_t* const alarm_ids, ow_ds18x20_result_t* const results,
+                   const size_t len, size_t* const alarms_found) {
+    owr_t res;
 
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("t != NULL", t != NULL);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id) || ow_ds18x20_is_s(ow, rom_id));
+    OW_ASSERT("ow != NULL", ow != NULL);
 
     ow_protect(ow, 1);
-    res = ow_ds18x20_read_raw(ow, rom_id, t);
+    res = ow_ds18x20_monitor_raw(ow, alarm_ids, results, len, alarms_found);
     ow_unprotect(ow, 1);
     return res;
 }
 
+#if OW_CFG_OS || __DOXYGEN__
+
 /**
- * \brief           Get resolution for `DS18B20` device
- * \param[in]       ow: 1-Wire handle
- * \param[in]       rom_id: 1-Wire device address to get resolution from
- * \return          Resolution in units of bits (`9 - 12`) on success, `0` otherwise
+ * \brief           Initialize pipelined conversion scheduler
+ *
+ * Devices are split to `group_count` groups of equal size. Conversion is started
+ * on each group separately with `MATCH ROM` command, and group is read and restarted
+ * as soon as its conversion time expired, while other groups are still converting.
+ *
+ * More groups give finer interleaving of reads with conversions.
+ * Bus is never idle when reading all groups takes longer than conversion time.
+ *
+ * \note            Scheduler is intended for externally powered devices only
+ * \param[out]      sched: Scheduler to initialize
+ * \param[in]       rom_ids: Array of devices to sample. Must be valid while scheduler is used
+ * \param[out]      results: Array of results, one for each device, updated with each sample
+ * \param[in]       rom_len: Number of entries in `rom_ids` and `results` arrays
+ * \param[in]       group_ticks: Array for conversion start times, one for each group
+ * \param[in]       group_count: Number of groups, `1 - rom_len`
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
  */
-uint8_t
-ow_ds18x20_get_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_id) {
-    uint8_t res = 0, br;
-
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("rom_id != NULL", rom_id != NULL);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
-
-    if (ow_reset_raw(ow) == owOK) {             /* Reset bus */
-        ow_match_rom_raw(ow, rom_id);           /* Select device */
-        ow_write_byte_ex_raw(ow, OW_CMD_RSCRATCHPAD, NULL); /* Send command to read scratchpad */
-
-        /* Read and ignore bytes */
-        ow_read_byte_ex_raw(ow, &br);
-        ow_read_byte_ex_raw(ow, &br);
-        ow_read_byte_ex_raw(ow, &br);
-        ow_read_byte_ex_raw(ow, &br);
+owr_t
+ow_ds18x20_sched_init(ow_ds18x20_sched_t* const sched, const ow_rom_t* const rom_ids, ow_ds18x20_result_t* const results,
+                      const size_t rom_len, uint32_t* const group_ticks, const size_t group_count) {
+    OW_ASSERT("sched != NULL", sched != NULL);
+    OW_ASSERT("rom_ids != NULL", rom_ids != NULL);
+    OW_ASSERT("results != NULL", results != NULL);
+    OW_ASSERT("rom_len > 0", rom_len > 0);
+    OW_ASSERT("group_ticks != NULL", group_ticks != NULL);
+    OW_ASSERT("group_count > 0 && group_count <= rom_len", group_count > 0 && group_count <= rom_len);
 
-        ow_read_byte_ex_raw(ow, &br);
-        res = ((br & 0x60) >> 0x05) + 9;  /* Read configuration byte and calculate bits */
+    memset(sched, 0x00, sizeof(*sched));
+    sched->rom_ids = rom_ids;
+    sched->results = results;
+    sched->rom_len = rom_len;
+    sched->group_ticks = group_ticks;
+    sched->group_size = (rom_len + group_count - 1) / group_count;
+    sched->group_count = (rom_len + sched->group_size - 1) / sched->group_size;
+    for (size_t i = 0; i < rom_len; ++i) {
+        results[i].status = owERR;              /* No sample yet */
     }
-
-    return res;
+    return owOK;
 }
 
 /**
- * \copydoc         ow_ds18x20_get_resolution_raw
- * \note            This function is thread-safe
+ * \brief           Start conversion on all devices of the group
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       sched: Scheduler handle
+ * \param[in]       group: Group index
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
  */
-uint8_t
-ow_ds18x20_get_resolution(ow_t* const ow, const ow_rom_t* const rom_id) {
-    uint8_t res;
+static owr_t
+prv_sched_start(ow_t* const ow, ow_ds18x20_sched_t* const sched, const size_t group) {
+    size_t first = group * sched->group_size;
 
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("rom_id != NULL", rom_id != NULL);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
-
-    ow_protect(ow, 1);
-    res = ow_ds18x20_get_resolution_raw(ow, rom_id);
-    ow_unprotect(ow, 1);
-    return res;
+    for (size_t i = first; i < sched->rom_len && i < first + sched->group_size; ++i) {
+        if (!ow_ds18x20_start_raw(ow, &sched->rom_ids[i])) {
+            return owERR;
+        }
+    }
+    sched->group_ticks[group] = ow_sys_get_tick(ow->arg);
+    return owOK;
 }
 
 /**
- * \brief           Set resolution for `DS18B20` sensor
- * \note            `DS18S20` has fixed `9-bit` resolution
+ * \brief           Process next scheduler operation
+ *
+ * Function starts groups not yet started, then reads and restarts next group
+ * when its conversion time expired. Single group is read per call,
+ * allowing other threads to access the bus between calls.
+ *
  * \param[in]       ow: 1-Wire handle
- * \param[in]       rom_id: 1-Wire device address to set resolution
- * \param[in]       bits: Number of resolution bits. Possible values are `9 - 12`
- * \return          `1` on success, `0` otherwise
+ * \param[in]       sched: Scheduler handle
+ * \param[out]      next_ms: Output variable to save time in milliseconds until next operation is due.
+ *                      Set to `NULL` if not used
+ * \return          \ref owOK on success, \ref owERR if any device is parasitically powered,
+ *                      member of \ref owr_t otherwise
  */
-uint8_t
-ow_ds18x20_set_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t bits) {
-    uint8_t th, tl, conf, res = 0;
-
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("bits >= 9 && bits <= 12", bits >= 9 && bits <= 12);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
-
-    if (ow_reset_raw(ow) == owOK) {
-        if (rom_id == NULL) {
-            ow_match_rom_raw(ow, rom_id);
-        } else {
-            ow_skip_rom_raw(ow);
-        }
-        ow_write_byte_ex_raw(ow, OW_CMD_RSCRATCHPAD, NULL); /* Send command to read scratchpad */
+owr_t
+ow_ds18x20_sched_step_raw(ow_t* const ow, ow_ds18x20_sched_t* const sched, uint32_t* const next_ms) {
+    size_t first, num;
+    uint32_t conv, elapsed;
+    uint8_t parasitic, bits;
+    owr_t res;
 
-        /* Read and ignore bytes */
-        ow_read_byte_ex_raw(ow, &th);
-        ow_read_byte_ex_raw(ow, &th);
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("sched != NULL", sched != NULL);
 
-        /* Read important data */
-        ow_read_byte_ex_raw(ow, &th);
-        ow_read_byte_ex_raw(ow, &tl);
-        ow_read_byte_ex_raw(ow, &conf);
+    if (next_ms != NULL) {
+        *next_ms = 0;
+    }
 
-        conf &= ~0x60;                          /* Remove configuration bits for temperature resolution */
-        switch (bits) {                         /* Check bits configuration */
-            case 12: conf |= 0x60; break;       /* 12-bits configuration */
-            case 11: conf |= 0x40; break;       /* 11-bits configuration */
-            case 10: conf |= 0x20; break;       /* 10-bits configuration */
-            default: break;                     /* 9-bits configuration */
+    /* First round, start conversion on all groups */
+    if (sched->started == 0) {
+        if ((res = prv_bus_parasitic(ow, sched->rom_ids, sched->rom_len, &parasitic)) != owOK) {
+            return res;
         }
+        if (parasitic) {
+            return owERR;                       /* Parasitic devices cannot convert while bus is used */
+        }
+        sched->start_tick = ow_sys_get_tick(ow->arg);
+    }
+    for (; sched->started < sched->group_count; ++sched->started) {
+        if ((res = prv_sched_start(ow, sched, sched->started)) != owOK) {
+            return res;
+        }
+    }
 
-        /* Write data back to device */
-        if (ow_reset_raw(ow) == owOK) {
-            ow_match_rom_raw(ow, rom_id);
-            ow_write_byte_ex_raw(ow, OW_CMD_WSCRATCHPAD, NULL);
-
-            ow_write_byte_ex_raw(ow, th, NULL);
-            ow_write_byte_ex_raw(ow, tl, NULL);
-            ow_write_byte_ex_raw(ow, conf, NULL);
+    /* Groups are restarted in order, next group to read is always the oldest one */
+    first = sched->cursor * sched->group_size;
+    num = sched->rom_len - first < sched->group_size ? sched->rom_len - first : sched->group_size;
+    bits = prv_cache_resolution(ow, &sched->rom_ids[first], num);
+    conv = OW_DS18X20_CONV_TIME(bits > 0 ? bits : 12);
+    elapsed = ow_sys_get_tick(ow->arg) - sched->group_ticks[sched->cursor];
+    if (elapsed < conv) {
+        if (next_ms != NULL) {
+            *next_ms = conv - elapsed;
+        }
+        return owOK;
+    }
 
-            /* Copy scratchpad to non-volatile memory */
-            if (ow_reset_raw(ow) == owOK) {
-                ow_match_rom_raw(ow, rom_id);
-                ow_write_byte_ex_raw(ow, OW_CMD_CPYSCRATCHPAD, NULL);
-                res = 1;
-            }
+    /* Read finished group and start next conversion immediately */
+    for (size_t i = first; i < first + num; ++i) {
+        if (prv_read_result(ow, &sched->rom_ids[i], &sched->results[i]) == owOK) {
+            ++sched->samples;
         }
     }
-    return res;
+    if ((res = prv_sched_start(ow, sched, sched->cursor)) != owOK) {
+        return res;
+    }
+    sched->cursor = (sched->cursor + 1) % sched->group_count;
+    return owOK;
 }
 
 /**
- * \copydoc         ow_ds18x20_set_resolution_raw
+ * \copydoc         ow_ds18x20_sched_step_raw
  * \note            This function is thread-safe
  */
-uint8_t
-ow_ds18x20_set_resolution(ow_t* const ow, const ow_rom_t* const rom_id, const uint8_t bits) {
-    uint8_t res;
+owr_t
+ow_ds18x20_sched_step(ow_t* const ow, ow_ds18x20_sched_t* const sched, uint32_t* const next_ms) {
+    owr_t res;
 
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("bits >= 9 && bits <= 12", bits >= 9 && bits <= 12);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("sched != NULL", sched != NULL);
 
     ow_protect(ow, 1);
-    res = ow_ds18x20_set_resolution_raw(ow, rom_id, bits);
+    res = ow_ds18x20_sched_step_raw(ow, sched, next_ms);
     ow_unprotect(ow, 1);
     return res;
 }
 
 /**
- * \brief           Set/clear temperature alarm high/low levels in units of degree Celcius
- * \note            `temp_h` and `temp_l` are high and low temperature alarms and can accept different values:
- *                      - `-55 % 125`, valid temperature range
- *                      - \ref OW_DS18X20_ALARM_DISABLE to disable temperature alarm (either high or low)
- *                      - \ref OW_DS18X20_ALARM_NOCHANGE to keep current alarm temperature (either high or low)
- *
- * Example usage would look something similar to:
- * \code{c}
-//Set alarm temperature; low = 10°C, high = 30°C
-ow_ds18x20_set_alarm_temp(&ow, dev_id, 10, 30);
-//Set alarm temperature; low = disable, high = no change
-ow_ds18x20_set_alarm_temp(&ow, dev_id, OW_DS18X20_ALARM_DISABLE, OW_DS18X20_ALARM_NOCHANGE);
-//Set alarm temperature; low = no change, high = disable
-ow_ds18x20_set_alarm_temp(&ow, dev_id, OW_DS18X20_ALARM_NOCHANGE, OW_DS18X20_ALARM_DISABLE);
-//Set alarm temperature; low = 10°C, high = 30°C
-ow_ds18x20_set_alarm_temp(&ow, dev_id, 10, 30);
-\endcode
+ * \brief           Run scheduler for specific time
  *
+ * Thread sleeps with \ref ow_sys_delay when no group is ready, bus is released in the meantime
  *
  * \param[in]       ow: 1-Wire handle
- * \param[in]       rom_id: 1-Wire device address
- * \param[in]       temp_l: Alarm low temperature
- * \param[in]       temp_h: Alarm high temperature
- * \return          `1` on success, `0` otherwise
+ * \param[in]       sched: Scheduler handle
+ * \param[in]       duration: Time to run scheduler in units of milliseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function is thread-safe
  */
-uint8_t
-ow_ds18x20_set_alarm_temp_raw(ow_t* const ow, const ow_rom_t* const rom_id, int8_t temp_l, int8_t temp_h) {
-    uint8_t res = 0, conf, th, tl;
+owr_t
+ow_ds18x20_sched_run(ow_t* const ow, ow_ds18x20_sched_t* const sched, const uint32_t duration) {
+    uint32_t start, next_ms;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("sched != NULL", sched != NULL);
+
+    start = ow_sys_get_tick(ow->arg);
+    do {
+        if ((res = ow_ds18x20_sched_step(ow, sched, &next_ms)) != owOK) {
+            return res;
+        }
+        if (next_ms > 0) {
+            ow_sys_delay(next_ms, ow->arg);
+        }
+    } while ((ow_sys_get_tick(ow->arg) - start) < duration);
+    return owOK;
+}
+
+/**
+ * \brief           Get achieved sample rate of the scheduler
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       sched: Scheduler handle
+ * \return          Number of successfully read samples per second since first conversion start
+ */
+float
+ow_ds18x20_sched_get_rate(ow_t* const ow, const ow_ds18x20_sched_t* const sched) {
+    uint32_t elapsed;
 
     OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+    OW_ASSERT0("sched != NULL", sched != NULL);
 
-    /* Check if there is need to do anything */
-    if (temp_l == OW_DS18X20_ALARM_NOCHANGE && temp_h == OW_DS18X20_ALARM_NOCHANGE) {
-        return 1;
+    elapsed = ow_sys_get_tick(ow->arg) - sched->start_tick;
+    if (sched->started == 0 || elapsed == 0) {
+        return 0.0f;
     }
+    return (float)sched->samples * 1000.0f / (float)elapsed;
+}
 
-    /* Check valid temp range for temperatures */
-    if (temp_l != OW_DS18X20_ALARM_NOCHANGE) {
-        if (temp_l == OW_DS18X20_ALARM_DISABLE || temp_l < OW_DS18X20_TEMP_MIN) {
-            temp_l = OW_DS18X20_TEMP_MIN;       /* Set alarm to minumum vlaue */
-        } else if (temp_l > OW_DS18X20_TEMP_MAX) {
-            temp_l = OW_DS18X20_TEMP_MAX;
-        }
+/**
+ * \brief           Reset bus, skip ROM and send all but last bit of conversion command
+ *
+ * Devices wait indefinitely between time slots, conversion starts when last bit is sent
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_arm_convert(ow_t* const ow) {
+    owr_t res;
+
+    if ((res = ow_reset_raw(ow)) != owOK
+        || (res = ow_write_byte_ex_raw(ow, OW_CMD_SKIPROM, NULL)) != owOK) {
+        return res;
     }
-    if (temp_h != OW_DS18X20_ALARM_NOCHANGE) {
-        if (temp_h == OW_DS18X20_ALARM_DISABLE || temp_h > OW_DS18X20_TEMP_MAX) {
-            temp_h = OW_DS18X20_TEMP_MAX;       /* Set alarm to maximal value */
-        } else if (temp_h < OW_DS18X20_TEMP_MIN) {
-            temp_h = OW_DS18X20_TEMP_MIN;
+    for (uint8_t i = 0; i < 7; ++i) {
+        if ((res = ow_write_bit_ex_raw(ow, (OW_DS18X20_CMD_CONVERT >> i) & 0x01, NULL)) != owOK) {
+            return res;
         }
     }
+    return owOK;
+}
 
-    if (ow_reset_raw(ow) == owOK) {
-        if (rom_id == NULL) {
-            ow_skip_rom_raw(ow);
-        } else {
-            ow_match_rom_raw(ow, rom_id);
-        }
-        ow_write_byte_ex_raw(ow, OW_CMD_RSCRATCHPAD, NULL);
-
-        /* Read and ignore 2 bytes */
-        ow_read_byte_ex_raw(ow, &th);
-        ow_read_byte_ex_raw(ow, &th);
+/**
+ * \brief           Get remaining deadline time of the bus
+ * \param[in]       b: Bus entry
+ * \return          Remaining time in units of milliseconds, `UINT32_MAX` when deadline is not armed
+ */
+static uint32_t
+prv_multi_remaining(ow_ds18x20_bus_t* const b) {
+#if OW_CFG_DEADLINE
+    return ow_get_deadline_remaining_raw(b->ow);
+#else
+    OW_UNUSED(b);
+    return UINT32_MAX;
+#endif /* OW_CFG_DEADLINE */
+}
 
-        /* Read important data */
-        ow_read_byte_ex_raw(ow, &th);
-        ow_read_byte_ex_raw(ow, &tl);
-        ow_read_byte_ex_raw(ow, &conf);
+/**
+ * \brief           Start temperature conversion on multiple buses at the same time and read all devices
+ *
+ * Each bus is first prepared with reset, `SKIP ROM` and all but last bit of conversion command.
+ * Last bit is then sent to all buses back-to-back, starting conversions within one bit slot
+ * of each bus, regardless of bus preparation time. Start time and skew to first bus are saved for each bus.
+ *
+ * Conversions complete in parallel. Buses are polled (or held with strong pullup when parasitically powered)
+ * in the same loop, total wait time is set by the slowest bus only.
+ * When deadline of a bus expires during the wait, its strong pullup is released
+ * and its status is set to \ref owERRTIMEOUT, other buses continue.
+ * The same applies to cancellation token of a bus, with status set to \ref owERRCANCEL.
+ * Afterwards, scratchpad of every listed device is read.
+ *
+ * \note            `rom_ids` of each bus shall list all devices on the bus, to detect parasitically powered devices reliably
+ * \note            Start time resolution is set by \ref ow_sys_get_tick, typically `1 ms`.
+ *                      Skew between consecutive buses is one bit slot (`~87 us`) plus low-level driver latency.
+ *                      Saved `skew_us` is bit slot estimate, or lower bound from start ticks when it is larger
+ *
+ * Function returns \ref owOK when conversion has been completed on all buses,
+ * each bus status is saved to `status` member of its entry and
+ * each device read status is saved to `status` member of its result entry.
+ *
+ * \param[in,out]   buses: Array of buses with `ow`, `rom_ids`, `results` and `rom_len` members set
+ * \param[in]       count: Number of entries in `buses` array
+ * \return          \ref owOK on success, \ref owERRCANCEL when any bus was cancelled,
+ *                      member of \ref owr_t otherwise
+ */
+owr_t
+ow_ds18x20_read_multi_raw(ow_ds18x20_bus_t* const buses, const size_t count) {
+    const uint8_t last_bit = (OW_DS18X20_CMD_CONVERT >> 7) & 0x01;
+    uint32_t first = 0, elapsed, delay = OW_DS18X20_CONV_TIME(12) / 2, slot_us;
+    ow_ds18x20_bus_t *b, *s;
+    size_t pending = 0;
+    uint8_t done;
+    owr_t res = owOK, sleep_res;
 
-        /* Fill new values */
-        th = temp_h == OW_DS18X20_ALARM_NOCHANGE ? (uint8_t)th : (uint8_t)temp_h;
-        tl = temp_l == OW_DS18X20_ALARM_NOCHANGE ? (uint8_t)tl : (uint8_t)temp_l;
+    OW_ASSERT("buses != NULL", buses != NULL);
+    OW_ASSERT("count > 0", count > 0);
 
-        /* Write scratchpad */
-        if (ow_reset_raw(ow) == owOK) {
-            ow_match_rom_raw(ow, rom_id);
-            ow_write_byte_ex_raw(ow, OW_CMD_WSCRATCHPAD, NULL);
+    /* Prepare all buses, conversion is not started yet */
+    for (size_t i = 0; i < count; ++i) {
+        b = &buses[i];
+        OW_ASSERT("buses[i].ow != NULL", b->ow != NULL);
+        OW_ASSERT("buses[i].rom_ids != NULL", b->rom_ids != NULL);
+        OW_ASSERT("buses[i].results != NULL", b->results != NULL);
+        OW_ASSERT("buses[i].rom_len > 0", b->rom_len > 0);
 
-            /* Write configuration register */
-            ow_write_byte_ex_raw(ow, th, NULL);
-            ow_write_byte_ex_raw(ow, tl, NULL);
-            ow_write_byte_ex_raw(ow, conf, NULL);
+        b->busy = 0;
+        b->skew_us = 0;
+        b->bits = prv_cache_resolution(b->ow, b->rom_ids, b->rom_len);
+        if ((b->status = prv_bus_parasitic(b->ow, b->rom_ids, b->rom_len, &b->parasitic)) == owOK) {
+            b->status = prv_arm_convert(b->ow);
+        }
+    }
 
-            /* Copy scratchpad to memory */
-            if (ow_reset_raw(ow) == owOK) {
-                ow_match_rom_raw(ow, rom_id);
-                ow_write_byte_ex_raw(ow, OW_CMD_CPYSCRATCHPAD, NULL);
+    /* Send last bit to all buses, with minimal time in-between */
+    slot_us = (ow_get_transfer_time(0, 1) + 7) / 8;  /* Single bit is one UART byte */
+    for (size_t i = 0; i < count; ++i) {
+        b = &buses[i];
+        if (b->status == owOK && (b->status = ow_write_bit_ex_raw(b->ow, last_bit, NULL)) == owOK) {
+            if (b->parasitic) {
+                ow_strong_pullup_raw(b->ow, 1);
+            }
+            b->start_tick = ow_sys_get_tick(b->ow->arg);
+            if (pending == 0) {
+                first = b->start_tick;
+            }
 
-                res = 1;
+            /* Tick difference of `n` guarantees more than `n - 1` milliseconds */
+            elapsed = b->start_tick - first;
+            b->skew_us = (uint32_t)pending * slot_us;
+            if (elapsed > 1 && (elapsed - 1) * 1000U > b->skew_us) {
+                b->skew_us = (elapsed - 1) * 1000U;
+            }
+            ++pending;
+            b->busy = 1;
+            if (OW_DS18X20_CONV_TIME(b->bits > 0 ? b->bits : 9) / 2 < delay) {
+                delay = OW_DS18X20_CONV_TIME(b->bits > 0 ? b->bits : 9) / 2;
             }
         }
     }
-    return res;
-}
-
-/**
- * \copydoc         ow_ds18x20_set_alarm_temp_raw
- * \note            This function is thread-safe
- */
-uint8_t
-ow_ds18x20_set_alarm_temp(ow_t* const ow, const ow_rom_t* const rom_id, int8_t temp_l, int8_t temp_h) {
-    uint8_t res;
 
-    OW_ASSERT0("ow != NULL", ow != NULL);
-    OW_ASSERT0("ow_ds18x20_is_b(ow, rom_id)", ow_ds18x20_is_b(ow, rom_id));
+    /* Wait for all conversions at the same time */
+    while (pending > 0) {
+        /* Sleep on busy bus with nearest deadline, so sleep never overruns any bus deadline */
+        s = NULL;
+        for (size_t i = 0; i < count; ++i) {
+            b = &buses[i];
+            if (b->busy && (s == NULL || prv_multi_remaining(b) < prv_multi_remaining(s))) {
+                s = b;
+            }
+        }
+        sleep_res = ow_delay_raw(s->ow, delay);
+        delay = OW_DS18X20_CONV_TIME(9) / 16;
+        for (size_t i = 0; i < count; ++i) {
+            b = &buses[i];
+            if (!b->busy) {
+                continue;
+            }
+            elapsed = ow_sys_get_tick(b->ow->arg) - b->start_tick;
+            done = 0;
+            if (b == s && sleep_res != owOK) {
+                b->status = sleep_res;
+                done = 1;
+            } else if (prv_multi_remaining(b) == 0) {
+                b->status = owERRTIMEOUT;
+                done = 1;
+#if OW_CFG_CANCEL
+            } else if (b->ow->cancel != NULL && ow_cancel_is_set(b->ow->cancel)) {
+                b->status = owERRCANCEL;
+                done = 1;
+#endif /* OW_CFG_CANCEL */
+            } else if (b->parasitic) {
+                /* Parasitically powered devices cannot signal completion */
+                done = elapsed >= OW_DS18X20_CONV_TIME(b->bits > 0 ? b->bits : 12);
+            } else if ((b->status = prv_check_done(b->ow, &done)) != owOK) {
+                done = 1;
+            } else if (!done && elapsed >= 2 * OW_DS18X20_CONV_TIME(b->bits > 0 ? b->bits : 12)) {
+                b->status = owERR;
+                done = 1;
+            }
+            if (done) {
+                if (b->parasitic) {
+                    ow_strong_pullup_raw(b->ow, 0); /* Release pullup on completion and on abort */
+                }
+                b->busy = 0;
+                --pending;
+            }
+        }
+    }
 
-    ow_protect(ow, 1);
-    res = ow_ds18x20_set_alarm_temp_raw(ow, rom_id, temp_l, temp_h);
-    ow_unprotect(ow, 1);
+    /* Read scratchpad of each device on converted buses */
+    for (size_t i = 0; i < count; ++i) {
+        b = &buses[i];
+        if (b->status == owOK) {
+            for (size_t j = 0; j < b->rom_len; ++j) {
+                prv_read_result(b->ow, &b->rom_ids[j], &b->results[j]);
+            }
+        } else if (res == owOK || b->status == owERRCANCEL) {
+            res = b->status;                    /* Cancellation takes precedence over other errors */
+        }
+    }
     return res;
 }
 
 /**
- * \brief           Search for `DS18x20` devices with alarm flag
- * \note            To reset search, use \ref ow_search_reset function
- * \param[in]       ow: 1-Wire handle
- * \param[out]      rom_id: Pointer to 8-byte long variable to save ROM
- * \return          \ref owOK on success, member of \ref owr_t otherwise
- */
-owr_t
-ow_ds18x20_search_alarm_raw(ow_t* const ow, ow_rom_t* const rom_id) {
-    return ow_search_with_command_raw(ow, 0xEC, rom_id);
-}
-
-/**
- * \copydoc         ow_ds18x20_search_alarm_raw
- * \note            This function is thread-safe
+ * \copydoc         ow_ds18x20_read_multi_raw
+ * \note            This function is thread-safe. All buses are locked for complete operation,
+ *                      in order of `buses` array. Application shall use the same order
+ *                      when it locks multiple buses elsewhere
  */
 owr_t
-ow_ds18x20_search_alarm(ow_t* const ow, ow_rom_t* const rom_id) {
+ow_ds18x20_read_multi(ow_ds18x20_bus_t* const buses, const size_t count) {
     owr_t res;
 
-    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("buses != NULL", buses != NULL);
+    OW_ASSERT("count > 0", count > 0);
 
-    ow_protect(ow, 1);
-    res = ow_ds18x20_search_alarm_raw(ow, rom_id);
-    ow_unprotect(ow, 1);
+    for (size_t i = 0; i < count; ++i) {
+        ow_protect(buses[i].ow, 1);
+    }
+    res = ow_ds18x20_read_multi_raw(buses, count);
+    for (size_t i = count; i > 0; --i) {
+        ow_unprotect(buses[i - 1].ow, 1);
+    }
     return res;
 }
 
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 /**
  * \brief           Check if ROM address matches `DS18B20` device
  * \param[in]       ow: 1-Wire handle
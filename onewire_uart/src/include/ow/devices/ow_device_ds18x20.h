@@ -55,9 +55,147 @@ extern "C" {
 #define OW_DS18X20_TEMP_MIN                     ((int8_t)-55)   /*!< Minimum temperature */
 #define OW_DS18X20_TEMP_MAX                     ((int8_t)125)   /*!< Maximal temperature */
 
+/**
+ * \brief           Convert temperature in units of `1/16` degree Celsius to milli-degrees Celsius
+ * \note            Conversion uses integer arithmetic only
+ * \param[in]       raw: Temperature in units of `1/16` degree Celsius
+ * \return          Temperature in units of milli-degrees Celsius
+ * \hideinitializer
+ */
+#define OW_DS18X20_RAW_TO_MCELSIUS(raw)         (((int32_t)(raw) * 125) / 2)
+
+#define OW_DS18X20_PARTIAL_TEMP                 2   /*!< Partial read of temperature bytes only */
+#define OW_DS18X20_PARTIAL_CONF                 5   /*!< Partial read of temperature, alarm and configuration bytes */
+
+#define OW_DS18X20_CHECK_DUPLICATE              0x01    /*!< Read data twice and accept it only when both reads match */
+#define OW_DS18X20_CHECK_PLAUSIBLE              0x02    /*!< Reject power-on value and changes larger than allowed step */
+
+#define OW_DS18X20_PARTIAL_CONFIRM              3   /*!< Default number of consecutive reads to confirm rejected change */
+
+/**
+ * \brief           Partial scratchpad read configuration and state
+ *
+ * Partial read does not read CRC byte, therefore data integrity is not guaranteed.
+ * Integrity is optionally checked with `flags` member.
+ * Structure shall be kept by application between consecutive reads of the same device
+ */
+typedef struct {
+    uint8_t len;                                /*!< Number of bytes to read, \ref OW_DS18X20_PARTIAL_TEMP or \ref OW_DS18X20_PARTIAL_CONF */
+    uint8_t flags;                              /*!< Integrity checks, combination of `OW_DS18X20_CHECK_*` flags */
+    int16_t max_step;                           /*!< Maximal allowed change from last temperature in units of `1/16` degree Celsius.
+                                                        Used with \ref OW_DS18X20_CHECK_PLAUSIBLE */
+    uint8_t resolution;                         /*!< Resolution in units of bits, or `0` when not known.
+                                                        Updated by partial read of configuration byte */
+    uint8_t confirm;                            /*!< Number of consecutive matching reads to accept value rejected
+                                                        by \ref OW_DS18X20_CHECK_PLAUSIBLE. Set to `0` to use \ref OW_DS18X20_PARTIAL_CONFIRM */
+    uint8_t last_valid;                         /*!< Set to `1` when `last` holds valid temperature.
+                                                        Application may clear it to accept next read as new baseline */
+    int16_t last;                               /*!< Last accepted temperature in units of `1/16` degree Celsius */
+    uint8_t cand_count;                         /*!< Number of consecutive rejected reads matching `cand` */
+    int16_t cand;                               /*!< Last rejected temperature in units of `1/16` degree Celsius */
+} ow_ds18x20_partial_t;
+
+/**
+ * \brief           Per-device cache entry
+ *
+ * Array of entries is attached to 1-Wire instance with \ref ow_ds18x20_cache_attach.
+ * Entries are filled automatically, when driver reads scratchpad of the device.
+ */
+typedef struct {
+    ow_rom_t rom;                               /*!< Device ROM address */
+    uint8_t flags;                              /*!< Entry flags, for internal use */
+    uint8_t th;                                 /*!< Alarm high register */
+    uint8_t tl;                                 /*!< Alarm low register */
+    uint8_t conf;                               /*!< Configuration register */
+#if OW_CFG_OS || __DOXYGEN__
+    int16_t raw;                                /*!< Last temperature in units of `1/16` degree Celsius */
+    uint32_t tick;                              /*!< Time of last temperature reading, see \ref ow_sys_get_tick */
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+} ow_ds18x20_cache_t;
+
+/**
+ * \brief           Single sensor reading, decoded from one scratchpad read
+ */
+typedef struct {
+    owr_t status;                               /*!< Read status, \ref owOK when other fields are valid, \ref owERRCRC on CRC mismatch */
+    int16_t raw;                                /*!< Raw temperature in units of `1/16` degree Celsius */
+    int32_t mcelsius;                           /*!< Temperature in units of milli-degrees Celsius,
+                                                        see \ref OW_DS18X20_RAW_TO_MCELSIUS */
+    uint8_t resolution;                         /*!< Resolution in units of bits (`9 - 12`) */
+    int8_t th;                                  /*!< Alarm high temperature in units of degree Celsius */
+    int8_t tl;                                  /*!< Alarm low temperature in units of degree Celsius */
+} ow_ds18x20_result_t;
+
+/**
+ * \brief           Sampling request of single device for bus capacity plan
+ */
+typedef struct {
+    uint8_t resolution;                         /*!< Resolution in units of bits (`9 - 12`). Use `12` for `DS18S20` */
+    uint8_t parasitic;                          /*!< Set to `1` when device is parasitically powered */
+    uint32_t period_ms;                         /*!< Requested sample period in units of milliseconds */
+} ow_ds18x20_plan_req_t;
+
+/**
+ * \brief           Bus capacity plan of admitted sampling requests
+ * \sa              ow_ds18x20_plan_add
+ */
+typedef struct {
+    uint32_t load_us;                           /*!< Bus time used by admitted devices in units of microseconds per second */
+    uint32_t rate_mhz;                          /*!< Total sample rate of admitted devices in units of millihertz */
+    size_t count;                               /*!< Number of admitted devices */
+} ow_ds18x20_plan_t;
+
+#if OW_CFG_OS || __DOXYGEN__
+
+/**
+ * \brief           Pipelined conversion scheduler
+ *
+ * Devices are split to groups. While one group converts, finished groups are read
+ * and restarted, keeping bus busy during conversion time
+ */
+typedef struct {
+    const ow_rom_t* rom_ids;                    /*!< Array of devices to sample */
+    ow_ds18x20_result_t* results;               /*!< Array of latest results, one for each device */
+    size_t rom_len;                             /*!< Number of devices */
+    uint32_t* group_ticks;                      /*!< Array of conversion start times, one for each group */
+    size_t group_count;                         /*!< Number of groups */
+    size_t group_size;                          /*!< Number of devices in each group */
+    size_t started;                             /*!< Number of groups started in first round */
+    size_t cursor;                              /*!< Index of next group to read */
+    uint32_t samples;                           /*!< Number of successfully read samples */
+    uint32_t start_tick;                        /*!< Time of first conversion start */
+} ow_ds18x20_sched_t;
+
+/**
+ * \brief           Single bus of time-aligned multi-bus conversion
+ * \sa              ow_ds18x20_read_multi
+ */
+typedef struct {
+    ow_t* ow;                                   /*!< 1-Wire handle of the bus */
+    const ow_rom_t* rom_ids;                    /*!< Array of all devices on the bus */
+    ow_ds18x20_result_t* results;               /*!< Array of results, one for each device */
+    size_t rom_len;                             /*!< Number of devices */
+    owr_t status;                               /*!< Conversion status of the bus */
+    uint32_t start_tick;                        /*!< Time of conversion start, see \ref ow_sys_get_tick */
+    uint32_t skew_us;                           /*!< Conversion start delay after first bus in units of microseconds.
+                                                        Estimated as one bit slot per preceding bus, see \ref ow_get_transfer_time,
+                                                        raised to elapsed whole milliseconds when driver latency is larger */
+    uint8_t bits;                               /*!< Highest resolution of devices on the bus, `0` when not known */
+    uint8_t parasitic;                          /*!< Set to `1` when any device on the bus is parasitically powered */
+    uint8_t busy;                               /*!< Set to `1` while conversion is in progress */
+} ow_ds18x20_bus_t;
+
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 uint8_t     ow_ds18x20_start_raw(ow_t* const ow, const ow_rom_t* const rom_id);
 uint8_t     ow_ds18x20_start(ow_t* const ow, const ow_rom_t* const rom_id);
 
+owr_t       ow_ds18x20_wait_raw(ow_t* const ow, const uint8_t bits);
+owr_t       ow_ds18x20_wait(ow_t* const ow, const uint8_t bits);
+
+uint8_t     ow_ds18x20_read_fixed_raw(ow_t* const ow, const ow_rom_t* const rom_id, int16_t* const t);
+uint8_t     ow_ds18x20_read_fixed(ow_t* const ow, const ow_rom_t* const rom_id, int16_t* const t);
+
 uint8_t     ow_ds18x20_read_raw(ow_t* const ow, const ow_rom_t* const rom_id, float* const t);
 uint8_t     ow_ds18x20_read(ow_t* const ow, const ow_rom_t* const rom_id, float* const t);
 
@@ -67,12 +205,71 @@ uint8_t     ow_ds18x20_set_resolution(ow_t* const ow, const ow_rom_t* const rom_
 uint8_t     ow_ds18x20_get_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_id);
 uint8_t     ow_ds18x20_get_resolution(ow_t* const ow, const ow_rom_t* const rom_id);
 
+uint8_t     ow_ds18x20_period_to_bits(const uint32_t period_ms, const size_t rom_len);
+owr_t       ow_ds18x20_plan_init(ow_ds18x20_plan_t* const plan);
+owr_t       ow_ds18x20_plan_add(ow_ds18x20_plan_t* const plan, const ow_ds18x20_plan_req_t* const reqs, const size_t len);
+owr_t       ow_ds18x20_plan_remove(ow_ds18x20_plan_t* const plan, const ow_ds18x20_plan_req_t* const reqs, const size_t len);
+float       ow_ds18x20_plan_get_headroom(const ow_ds18x20_plan_t* const plan);
+float       ow_ds18x20_plan_get_max_rate(const ow_ds18x20_plan_t* const plan);
+owr_t       ow_ds18x20_adapt_resolution_raw(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len,
+                                            const uint32_t* const periods, size_t* const changed);
+owr_t       ow_ds18x20_adapt_resolution(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len,
+                                        const uint32_t* const periods, size_t* const changed);
+
 uint8_t     ow_ds18x20_set_alarm_temp_raw(ow_t* const ow, const ow_rom_t* const rom_id, int8_t temp_l, int8_t temp_h);
 uint8_t     ow_ds18x20_set_alarm_temp(ow_t* const ow, const ow_rom_t* const rom_id, int8_t temp_l, int8_t temp_h);
 
+owr_t       ow_ds18x20_broadcast_config_raw(ow_t* const ow, const uint8_t bits, const int8_t temp_l, const int8_t temp_h,
+                                            const ow_rom_t* const rom_ids, const size_t rom_len);
+owr_t       ow_ds18x20_broadcast_config(ow_t* const ow, const uint8_t bits, const int8_t temp_l, const int8_t temp_h,
+                                        const ow_rom_t* const rom_ids, const size_t rom_len);
+
+owr_t       ow_ds18x20_read_ex_raw(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_result_t* const result);
+owr_t       ow_ds18x20_read_ex(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_result_t* const result);
+
+#if (OW_CFG_OS && OW_CFG_DS18X20_CACHE) || __DOXYGEN__
+owr_t       ow_ds18x20_read_cached_raw(ow_t* const ow, const ow_rom_t* const rom_id, const uint32_t max_age_ms, int16_t* const t);
+owr_t       ow_ds18x20_read_cached(ow_t* const ow, const ow_rom_t* const rom_id, const uint32_t max_age_ms, int16_t* const t);
+#endif /* (OW_CFG_OS && OW_CFG_DS18X20_CACHE) || __DOXYGEN__ */
+
+owr_t       ow_ds18x20_read_partial_raw(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_partial_t* const p, int16_t* const t);
+owr_t       ow_ds18x20_read_partial(ow_t* const ow, const ow_rom_t* const rom_id, ow_ds18x20_partial_t* const p, int16_t* const t);
+
+owr_t       ow_ds18x20_read_power_raw(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const parasitic);
+owr_t       ow_ds18x20_read_power(ow_t* const ow, const ow_rom_t* const rom_id, uint8_t* const parasitic);
+
+owr_t       ow_ds18x20_convert_raw(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len);
+owr_t       ow_ds18x20_convert(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len);
+
+owr_t       ow_ds18x20_read_all_raw(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len, ow_ds18x20_result_t* const results);
+owr_t       ow_ds18x20_read_all(ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len, ow_ds18x20_result_t* const results);
+
+void        ow_ds18x20_decode_batch(const uint8_t* const data, const size_t count, int32_t* const mcelsius);
+
+#if OW_CFG_DS18X20_CACHE || __DOXYGEN__
+owr_t       ow_ds18x20_cache_attach(ow_t* const ow, ow_ds18x20_cache_t* const entries, const size_t len);
+owr_t       ow_ds18x20_cache_invalidate(ow_t* const ow, const ow_rom_t* const rom_id);
+#endif /* OW_CFG_DS18X20_CACHE || __DOXYGEN__ */
+
 owr_t       ow_ds18x20_search_alarm_raw(ow_t* const ow, ow_rom_t* const rom_id);
 owr_t       ow_ds18x20_search_alarm(ow_t* const ow, ow_rom_t* const rom_id);
 
+owr_t       ow_ds18x20_monitor_raw(ow_t* const ow, ow_rom_t* const alarm_ids, ow_ds18x20_result_t* const results,
+                                   const size_t len, size_t* const alarms_found);
+owr_t       ow_ds18x20_monitor(ow_t* const ow, ow_rom_t* const alarm_ids, ow_ds18x20_result_t* const results,
+                               const size_t len, size_t* const alarms_found);
+
+#if OW_CFG_OS || __DOXYGEN__
+owr_t       ow_ds18x20_sched_init(ow_ds18x20_sched_t* const sched, const ow_rom_t* const rom_ids, ow_ds18x20_result_t* const results,
+                                  const size_t rom_len, uint32_t* const group_ticks, const size_t group_count);
+owr_t       ow_ds18x20_sched_step_raw(ow_t* const ow, ow_ds18x20_sched_t* const sched, uint32_t* const next_ms);
+owr_t       ow_ds18x20_sched_step(ow_t* const ow, ow_ds18x20_sched_t* const sched, uint32_t* const next_ms);
+owr_t       ow_ds18x20_sched_run(ow_t* const ow, ow_ds18x20_sched_t* const sched, const uint32_t duration);
+float       ow_ds18x20_sched_get_rate(ow_t* const ow, const ow_ds18x20_sched_t* const sched);
+owr_t       ow_ds18x20_read_multi_raw(ow_ds18x20_bus_t* const buses, const size_t count);
+owr_t       ow_ds18x20_read_multi(ow_ds18x20_bus_t* const buses, const size_t count);
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 uint8_t     ow_ds18x20_is_b(ow_t* const ow, const ow_rom_t* const rom_id);
 uint8_t     ow_ds18x20_is_s(ow_t* const ow, const ow_rom_t* const rom_id);
 
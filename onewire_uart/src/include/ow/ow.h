@@ -37,6 +37,9 @@
 #include <stdint.h>
 #include <stddef.h>
 #include "ow_config.h"
+#if OW_CFG_CANCEL
+#include <stdatomic.h>
+#endif /* OW_CFG_CANCEL */
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,6 +65,9 @@ typedef enum {
     owERRBAUD,                                  /*!< Error setting baudrate */
     owPARERR ,                                  /*!< Parameter error */
     owERR,                                      /*!< General-Purpose error */
+    owERRCRC,                                   /*!< CRC check of received data failed */
+    owERRTIMEOUT,                               /*!< Operation did not complete in time */
+    owERRCANCEL,                                /*!< Operation was cancelled with cancellation token */
 } owr_t;
 
 /**
@@ -71,6 +77,20 @@ typedef struct {
     uint8_t rom[8];                             /*!< 8-bytes ROM address */
 } ow_rom_t;
 
+#if OW_CFG_CANCEL || __DOXYGEN__
+
+/**
+ * \brief           Cancellation token
+ *
+ * Token is set from any thread with \ref ow_cancel,
+ * operations on the bus it is attached to check it between transfers
+ */
+typedef struct {
+    atomic_uint_least8_t set;                   /*!< Set to `1` when cancellation is requested */
+} ow_cancel_t;
+
+#endif /* OW_CFG_CANCEL || __DOXYGEN__ */
+
 /**
  * \defgroup        OW_LL Low-Level functions
  * \brief           Low-level device dependant functions
@@ -119,6 +139,64 @@ typedef struct {
      * \return      `1` on success, `0` otherwise
      */
     uint8_t (*tx_rx)(const uint8_t* tx, uint8_t* rx, size_t len, void* arg);
+
+    /**
+     * \brief       Enable or disable strong pullup on 1-Wire line
+     *
+     * Optional function, set to `NULL` if hardware has no strong pullup.
+     * Parasitically powered devices draw current from the line during temperature conversion
+     * and EEPROM write operations, where weak pullup resistor is not sufficient.
+     *
+     * \param[in]   enable: Set to `1` to drive line high with strong pullup, `0` to release it
+     * \param[in]   arg: Custom argument passed to \ref ow_init function
+     * \return      `1` on success, `0` otherwise
+     */
+    uint8_t (*strong_pullup)(uint8_t enable, void* arg);
+
+    /**
+     * \brief       Transmit and receive bytes over UART hardware within limited time
+     *
+     * Optional function, set to `NULL` if not supported. Same as `tx_rx`,
+     * but exchange must be aborted when it does not complete in `timeout` milliseconds.
+     * Used instead of `tx_rx` when deadline is armed, see \ref ow_protect_deadline
+     *
+     * \param[in]   tx: Data to transmit over UART
+     * \param[out]  rx: Array to write received data to
+     * \param[in]   len: Number of bytes to exchange
+     * \param[in]   timeout: Maximal exchange time in units of milliseconds, always greater than `0`
+     * \param[in]   arg: Custom argument passed to \ref ow_init function
+     * \return      `1` on success, `0` otherwise
+     */
+    uint8_t (*tx_rx_timeout)(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg);
+
+    /**
+     * \brief       Start transmission over UART without waiting for it to complete
+     *
+     * Optional function for non-blocking operation, set to `NULL` if not supported.
+     * All bytes must be accepted (copied or queued) before function returns,
+     * data received afterwards are read with `rx_read` function.
+     * Data received before the call shall be discarded.
+     * Used by \ref OW_ASYNC module
+     *
+     * \param[in]   tx: Data to transmit over UART
+     * \param[in]   len: Number of bytes to transmit
+     * \param[in]   arg: Custom argument passed to \ref ow_init function
+     * \return      `1` on success, `0` otherwise
+     */
+    uint8_t (*tx_start)(const uint8_t* tx, size_t len, void* arg);
+
+    /**
+     * \brief       Read already received bytes from UART without waiting
+     *
+     * Optional function for non-blocking operation, set to `NULL` if not supported.
+     * Must be implemented when `tx_start` is implemented
+     *
+     * \param[out]  rx: Array to write received data to
+     * \param[in]   len: Maximal number of bytes to read
+     * \param[in]   arg: Custom argument passed to \ref ow_init function
+     * \return      Number of bytes written to `rx`, `0` when no data are available
+     */
+    size_t (*rx_read)(uint8_t* rx, size_t len, void* arg);
 } ow_ll_drv_t;
 
 /**
@@ -134,12 +212,41 @@ typedef struct {
 uint8_t ow_sys_mutex_create(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg);
 uint8_t ow_sys_mutex_delete(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg);
 uint8_t ow_sys_mutex_wait(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg);
+uint8_t ow_sys_mutex_wait_timeout(OW_CFG_OS_MUTEX_HANDLE* mutex, const uint32_t timeout, void* arg);
 uint8_t ow_sys_mutex_release(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg);
+uint8_t ow_sys_delay(const uint32_t ms, void* arg);
+uint32_t ow_sys_get_tick(void* arg);
+uint8_t ow_sys_sem_create(OW_CFG_OS_SEM_HANDLE* sem, void* arg);
+uint8_t ow_sys_sem_delete(OW_CFG_OS_SEM_HANDLE* sem, void* arg);
+uint8_t ow_sys_sem_wait(OW_CFG_OS_SEM_HANDLE* sem, const uint32_t timeout, void* arg);
+uint8_t ow_sys_sem_release(OW_CFG_OS_SEM_HANDLE* sem, void* arg);
 
 /**
  * \}
  */
 
+#if OW_CFG_ARBITER || __DOXYGEN__
+
+#define OW_PRIO_LOW                 0           /*!< Priority of background operations, such as enumeration or logging */
+#define OW_PRIO_NORMAL              1           /*!< Priority of regular operations */
+#define OW_PRIO_HIGH                2           /*!< Priority of control loop operations */
+#define OW_PRIO_CRITICAL            3           /*!< Priority of alarm and safety related operations */
+
+/**
+ * \brief           Bus wait time statistics of single priority class
+ */
+typedef struct {
+    uint32_t count;                             /*!< Number of bus acquisitions */
+    uint32_t contended;                         /*!< Number of acquisitions, which had to wait for the bus */
+    uint32_t timeouts;                          /*!< Number of acquisitions, which failed due to timeout */
+    uint32_t wait_total;                        /*!< Total wait time in units of milliseconds */
+    uint32_t wait_max;                          /*!< Maximal wait time in units of milliseconds */
+} ow_arb_stats_t;
+
+struct ow_arb_waiter;
+
+#endif /* OW_CFG_ARBITER || __DOXYGEN__ */
+
 /**
  * \brief           1-Wire structure
  */
@@ -154,6 +261,24 @@ typedef struct {
 #if OW_CFG_OS || __DOXYGEN__
     OW_CFG_OS_MUTEX_HANDLE mutex;               /*!< Mutex handle */
 #endif /* OW_CFG_OS || __DOXYGEN__ */
+#if OW_CFG_ARBITER || __DOXYGEN__
+    OW_CFG_OS_MUTEX_HANDLE arb_mutex;           /*!< Mutex protecting arbiter state */
+    struct ow_arb_waiter* arb_waiters;          /*!< Threads waiting for the bus, highest priority first */
+    uint8_t arb_busy;                           /*!< Set to `1` while bus is granted to a thread */
+    ow_arb_stats_t arb_stats[OW_CFG_ARBITER_PRIOS]; /*!< Wait time statistics of each priority class */
+#endif /* OW_CFG_ARBITER || __DOXYGEN__ */
+#if OW_CFG_DEADLINE || __DOXYGEN__
+    uint32_t deadline;                          /*!< Tick when armed deadline expires */
+    uint8_t deadline_set;                       /*!< Set to `1` when deadline is armed */
+#endif /* OW_CFG_DEADLINE || __DOXYGEN__ */
+#if OW_CFG_CANCEL || __DOXYGEN__
+    ow_cancel_t* cancel;                        /*!< Attached cancellation token, `NULL` when not used */
+    uint8_t cancel_reset;                       /*!< Set to `1` when bus was reset after cancellation */
+#endif /* OW_CFG_CANCEL || __DOXYGEN__ */
+#if OW_CFG_DS18X20_CACHE || __DOXYGEN__
+    void* ds18x20_cache;                        /*!< DS18x20 per-device cache entries, see \ref ow_ds18x20_cache_attach */
+    size_t ds18x20_cache_len;                   /*!< Number of DS18x20 cache entries */
+#endif /* OW_CFG_DS18X20_CACHE || __DOXYGEN__ */
 } ow_t;
 
 /**
@@ -168,6 +293,24 @@ typedef struct {
  */
 typedef owr_t (*ow_search_cb_fn) (ow_t* const ow, const ow_rom_t* const rom_id, size_t index, void* arg);
 
+/**
+ * \brief           Search state, to resume search after bus was released
+ */
+typedef struct {
+    ow_rom_t rom;                               /*!< ROM address of last device found */
+    uint8_t disrepancy;                         /*!< Disrepancy value on last search */
+} ow_search_state_t;
+
+/**
+ * \brief           Bus hold and wait times of search, which releases the bus after each device
+ */
+typedef struct {
+    uint32_t slices;                            /*!< Number of times bus was acquired */
+    uint32_t hold_max;                          /*!< Maximal time bus was held at once in units of milliseconds */
+    uint32_t wait_total;                        /*!< Total time waiting to acquire the bus again in units of milliseconds */
+    uint32_t wait_max;                          /*!< Maximal time waiting to acquire the bus in units of milliseconds */
+} ow_search_stats_t;
+
 #define OW_UNUSED(x)                ((void)(x)) /*!< Unused variable macro */
 
 /**
@@ -218,6 +361,9 @@ typedef owr_t (*ow_search_cb_fn) (ow_t* const ow, const ow_rom_t* const rom_id,
 #define OW_CMD_MATCHROM             0x55        /*!< Match ROM command. Select device with specific ROM */
 #define OW_CMD_SKIPROM              0xCC        /*!< Skip ROM, select all devices */
 
+#define OW_BAUD_RESET               9600        /*!< UART baudrate for reset and presence pulse */
+#define OW_BAUD_DATA                115200      /*!< UART baudrate for read and write time slots */
+
 
 owr_t       ow_init(ow_t* const ow, const ow_ll_drv_t* const ll_drv, void* arg);
 void        ow_deinit(ow_t* const ow);
@@ -225,6 +371,33 @@ void        ow_deinit(ow_t* const ow);
 owr_t       ow_protect(ow_t* const ow, const uint8_t protect);
 owr_t       ow_unprotect(ow_t* const ow, const uint8_t protect);
 
+#if OW_CFG_ARBITER || __DOXYGEN__
+owr_t       ow_protect_ex(ow_t* const ow, const uint8_t prio, const uint32_t timeout);
+owr_t       ow_unprotect_ex(ow_t* const ow);
+owr_t       ow_get_arb_stats(ow_t* const ow, const uint8_t prio, ow_arb_stats_t* const stats, const uint8_t clear);
+#endif /* OW_CFG_ARBITER || __DOXYGEN__ */
+
+#if OW_CFG_DEADLINE || __DOXYGEN__
+owr_t       ow_protect_deadline(ow_t* const ow, const uint32_t timeout);
+owr_t       ow_unprotect_deadline(ow_t* const ow);
+owr_t       ow_set_deadline_raw(ow_t* const ow, const uint32_t timeout);
+owr_t       ow_clear_deadline_raw(ow_t* const ow);
+uint32_t    ow_get_deadline_remaining_raw(ow_t* const ow);
+#endif /* OW_CFG_DEADLINE || __DOXYGEN__ */
+
+#if OW_CFG_CANCEL || __DOXYGEN__
+owr_t       ow_cancel_init(ow_cancel_t* const token);
+owr_t       ow_cancel(ow_cancel_t* const token);
+owr_t       ow_cancel_clear(ow_cancel_t* const token);
+uint8_t     ow_cancel_is_set(ow_cancel_t* const token);
+owr_t       ow_set_cancel_raw(ow_t* const ow, ow_cancel_t* const token);
+owr_t       ow_set_cancel(ow_t* const ow, ow_cancel_t* const token);
+#endif /* OW_CFG_CANCEL || __DOXYGEN__ */
+
+#if OW_CFG_OS || __DOXYGEN__
+owr_t       ow_delay_raw(ow_t* const ow, const uint32_t ms);
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 owr_t       ow_reset_raw(ow_t* const ow);
 owr_t       ow_reset(ow_t* const ow);
 
@@ -236,6 +409,17 @@ owr_t       ow_read_byte_ex(ow_t* const ow, uint8_t* const br);
 
 owr_t       ow_read_bit_ex_raw(ow_t* const ow, uint8_t* const br);
 owr_t       ow_read_bit_ex(ow_t* const ow, uint8_t* const br);
+owr_t       ow_write_bit_ex_raw(ow_t* const ow, const uint8_t btw, uint8_t* const br);
+owr_t       ow_write_bit_ex(ow_t* const ow, const uint8_t btw, uint8_t* const br);
+
+owr_t       ow_write_bytes_ex_raw(ow_t* const ow, const uint8_t* const btw, uint8_t* const br, const size_t len);
+owr_t       ow_write_bytes_ex(ow_t* const ow, const uint8_t* const btw, uint8_t* const br, const size_t len);
+
+owr_t       ow_read_bytes_ex_raw(ow_t* const ow, uint8_t* const br, const size_t len);
+owr_t       ow_read_bytes_ex(ow_t* const ow, uint8_t* const br, const size_t len);
+
+owr_t       ow_strong_pullup_raw(ow_t* const ow, const uint8_t enable);
+owr_t       ow_strong_pullup(ow_t* const ow, const uint8_t enable);
 
 owr_t       ow_search_reset_raw(ow_t* const ow);
 owr_t       ow_search_reset(ow_t* const ow);
@@ -255,6 +439,13 @@ owr_t       ow_search_devices_with_command(ow_t* const ow, const uint8_t cmd, ow
 owr_t       ow_search_devices_raw(ow_t* const ow, ow_rom_t* const rom_id_arr, const size_t rom_len, size_t* const roms_found);
 owr_t       ow_search_devices(ow_t* const ow, ow_rom_t* const rom_id_arr, const size_t rom_len, size_t* const roms_found);
 
+#if OW_CFG_OS || __DOXYGEN__
+owr_t       ow_search_with_command_callback_yield(ow_t* const ow, const uint8_t cmd, size_t* const roms_found,
+                                                  const ow_search_cb_fn func, void* arg, ow_search_stats_t* const stats);
+owr_t       ow_search_devices_with_command_yield(ow_t* const ow, const uint8_t cmd, ow_rom_t* const rom_id_arr,
+                                                 const size_t rom_len, size_t* const roms_found, ow_search_stats_t* const stats);
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 owr_t       ow_match_rom_raw(ow_t* const ow, const ow_rom_t* const rom_id);
 owr_t       ow_match_rom(ow_t* const ow, const ow_rom_t* const rom_id);
 
@@ -262,6 +453,7 @@ owr_t       ow_skip_rom_raw(ow_t* const ow);
 owr_t       ow_skip_rom(ow_t* const ow);
 
 uint8_t     ow_crc(const void* const in, const size_t len);
+uint32_t    ow_get_transfer_time(const size_t resets, const size_t bytes);
 
 /* Legacy functions, deprecated, to be removed in next major release */
 uint8_t     ow_write_byte_raw(ow_t* const ow, const uint8_t b);
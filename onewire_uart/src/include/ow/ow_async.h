@@ -0,0 +1,127 @@
+/**
+ * \file            ow_async.h
+ * \brief           Non-blocking transaction header
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_ASYNC_H
+#define OW_HDR_ASYNC_H
+
+#include "ow/ow.h"
+
+#if OW_CFG_ASYNC || __DOXYGEN__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         OW
+ * \defgroup        OW_ASYNC Non-blocking transactions
+ * \brief           Transactions driven by received UART bytes
+ * \{
+ *
+ * Transaction is a list of reset, write and read operations, executed on single bus.
+ * Instead of waiting in low-level `tx_rx` function, each UART chunk is started with `tx_start`
+ * and transaction advances in \ref ow_async_process when its bytes are received.
+ * Single thread can drive many buses at the same time, typically from event loop
+ * that calls \ref ow_async_process when UART of the bus becomes readable.
+ *
+ * \note            Bus mutex is not used. Bus must not be accessed by other functions
+ *                  while transaction is in progress
+ */
+
+struct ow_async;
+
+/**
+ * \brief           Operation type of transaction
+ */
+typedef enum {
+    OW_ASYNC_RESET,                             /*!< Reset pulse, fails with \ref owERRPRESENCE when no device replies */
+    OW_ASYNC_WRITE,                             /*!< Write bytes, response is optionally read back */
+    OW_ASYNC_READ,                              /*!< Read bytes */
+} ow_async_op_type_t;
+
+/**
+ * \brief           Single operation of transaction
+ */
+typedef struct {
+    ow_async_op_type_t type;                    /*!< Operation type */
+    const uint8_t* tx;                          /*!< Bytes to write, used by \ref OW_ASYNC_WRITE */
+    uint8_t* rx;                                /*!< Array to save read bytes to. Optional for \ref OW_ASYNC_WRITE */
+    size_t len;                                 /*!< Number of bytes to write or read */
+} ow_async_op_t;
+
+/**
+ * \brief           Transaction completion function
+ * \param[in]       async: Transaction handle. New transaction may be started from the function
+ * \param[in]       res: Transaction result, \ref owOK on success, member of \ref owr_t otherwise
+ * \param[in]       arg: User argument
+ */
+typedef void (*ow_async_done_fn)(struct ow_async* const async, owr_t res, void* arg);
+
+/**
+ * \brief           Transaction handle of single bus
+ */
+typedef struct ow_async {
+    ow_t* ow;                                   /*!< 1-Wire handle */
+    const ow_async_op_t* ops;                   /*!< Operations of current transaction */
+    size_t op_count;                            /*!< Number of operations */
+    size_t op;                                  /*!< Index of current operation */
+    size_t off;                                 /*!< Number of completed bytes of current operation */
+    size_t chunk;                               /*!< Number of 1-Wire bytes in current chunk */
+    size_t expected;                            /*!< Number of UART bytes of current chunk */
+    size_t received;                            /*!< Number of UART bytes received for current chunk */
+    uint8_t buff[8 * OW_CFG_BATCH_BYTES];       /*!< UART data of current chunk */
+    uint32_t time;                              /*!< Time of last progress, in units of milliseconds */
+    uint8_t busy;                               /*!< Set to `1` while transaction is in progress */
+    ow_async_done_fn done;                      /*!< Completion function */
+    void* arg;                                  /*!< User argument for completion function */
+} ow_async_t;
+
+owr_t       ow_async_init(ow_async_t* const async, ow_t* const ow);
+owr_t       ow_async_start(ow_async_t* const async, const ow_async_op_t* const ops, const size_t op_count,
+                           const ow_async_done_fn done, void* const arg, const uint32_t now);
+owr_t       ow_async_process(ow_async_t* const async, const uint32_t now);
+owr_t       ow_async_check_timeout(ow_async_t* const async, const uint32_t now, const uint32_t timeout);
+owr_t       ow_async_abort(ow_async_t* const async, const owr_t res);
+uint8_t     ow_async_is_busy(const ow_async_t* const async);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_CFG_ASYNC || __DOXYGEN__ */
+
+#endif /* OW_HDR_ASYNC_H */
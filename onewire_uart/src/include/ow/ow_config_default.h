@@ -64,6 +64,162 @@ extern "C" {
 #define OW_CFG_OS_MUTEX_HANDLE                  void *
 #endif
 
+/**
+ * \brief           Semaphore handle type
+ *
+ * \note            This value must be set in case \ref OW_CFG_WORKER or \ref OW_CFG_ARBITER is set to `1`,
+ *                  or when low-level driver waits for transfer completion on semaphore.
+ *                  If data type is not known to compiler, include header file with
+ *                  definition before you define handle type
+ */
+#ifndef OW_CFG_OS_SEM_HANDLE
+#define OW_CFG_OS_SEM_HANDLE                    void *
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` per-device cache in DS18x20 driver
+ *
+ * When enabled, application may attach array of cache entries to 1-Wire instance
+ * with \ref ow_ds18x20_cache_attach function. Driver then keeps configuration registers
+ * of each device, to avoid unnecessary bus transactions and EEPROM writes.
+ */
+#ifndef OW_CFG_DS18X20_CACHE
+#define OW_CFG_DS18X20_CACHE                    1
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` periodic sampler module
+ *
+ * Sampler distributes samples to consumer threads through lock-free ring buffer,
+ * implemented with `C11` atomic operations.
+ *
+ * \note            \ref OW_CFG_OS must be enabled to use sampler
+ */
+#ifndef OW_CFG_SAMPLER
+#define OW_CFG_SAMPLER                          0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` bus worker module
+ *
+ * Worker thread owns the bus and executes operations submitted by other threads
+ * through lock-free queue, implemented with `C11` atomic operations.
+ *
+ * \note            \ref OW_CFG_OS must be enabled to use worker.
+ *                  Semaphore functions of \ref OW_SYS group must be implemented
+ */
+#ifndef OW_CFG_WORKER
+#define OW_CFG_WORKER                           0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` non-blocking transaction module
+ *
+ * Transactions progress as UART bytes arrive, many buses can be driven from single thread.
+ * Low-level driver must implement `tx_start` and `rx_read` functions.
+ *
+ * \note            Operating system is not required
+ */
+#ifndef OW_CFG_ASYNC
+#define OW_CFG_ASYNC                            0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` multi-bus group module
+ *
+ * Group runs enumeration and `DS18x20` polls on many buses with pool of worker threads.
+ * Idle workers steal pending bus jobs from other workers, implemented with `C11` atomic operations.
+ *
+ * \note            \ref OW_CFG_OS must be enabled to use group.
+ *                  Semaphore functions of \ref OW_SYS group must be implemented
+ */
+#ifndef OW_CFG_GROUP
+#define OW_CFG_GROUP                            0
+#endif
+
+/**
+ * \brief           Maximal number of buses in single group
+ */
+#ifndef OW_CFG_GROUP_BUSES
+#define OW_CFG_GROUP_BUSES                      8
+#endif
+
+/**
+ * \brief           Maximal number of worker threads of single group
+ */
+#ifndef OW_CFG_GROUP_WORKERS
+#define OW_CFG_GROUP_WORKERS                    4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` priority bus arbiter
+ *
+ * Arbiter grants the bus to waiting thread with highest priority,
+ * see \ref ow_protect_ex function.
+ *
+ * \note            \ref OW_CFG_OS must be enabled to use arbiter.
+ *                  Semaphore functions of \ref OW_SYS group must be implemented
+ */
+#ifndef OW_CFG_ARBITER
+#define OW_CFG_ARBITER                          0
+#endif
+
+/**
+ * \brief           Number of arbiter priority classes
+ *
+ * Priorities are numbered from `0` (lowest) to `OW_CFG_ARBITER_PRIOS - 1` (highest)
+ */
+#ifndef OW_CFG_ARBITER_PRIOS
+#define OW_CFG_ARBITER_PRIOS                    4
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` operation deadlines
+ *
+ * Bus owner may arm deadline, see \ref ow_protect_deadline function.
+ * Every transfer checks remaining time and passes it to low-level driver,
+ * operations abort with \ref owERRTIMEOUT when deadline expires.
+ *
+ * \note            \ref OW_CFG_OS must be enabled to use deadlines.
+ *                  \ref ow_sys_mutex_wait_timeout function must be implemented
+ */
+#ifndef OW_CFG_DEADLINE
+#define OW_CFG_DEADLINE                         0
+#endif
+
+/**
+ * \brief           Enables `1` or disables `0` cooperative cancellation
+ *
+ * Cancellation token may be attached to the bus, see \ref ow_set_cancel function.
+ * Every transfer checks the token, operations abort with \ref owERRCANCEL
+ * when it is set from another thread.
+ */
+#ifndef OW_CFG_CANCEL
+#define OW_CFG_CANCEL                           0
+#endif
+
+/**
+ * \brief           Longest time in units of milliseconds, thread sleeps between token checks
+ *
+ * Waits with \ref ow_delay_raw are split to steps of this length
+ */
+#ifndef OW_CFG_CANCEL_POLL
+#define OW_CFG_CANCEL_POLL                      10
+#endif
+
+/**
+ * \brief           Maximal number of bytes exchanged with single low-level transfer
+ *
+ * Multi-byte operations, such as \ref ow_write_bytes_ex_raw or \ref ow_read_bytes_ex_raw,
+ * encode up to this number of bytes into one buffer and pass it to low-level `tx_rx` function at once.
+ * Each 1-Wire byte requires `8` bytes of UART data, which are allocated on the stack.
+ *
+ * Default value allows `MATCH ROM` sequence together with function command in single transfer
+ */
+#ifndef OW_CFG_BATCH_BYTES
+#define OW_CFG_BATCH_BYTES                      10
+#endif
+
 /**
  * \}
  */
@@ -0,0 +1,137 @@
+/**
+ * \file            ow_group.h
+ * \brief           Multi-bus group header
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_GROUP_H
+#define OW_HDR_GROUP_H
+
+#include "ow/ow.h"
+
+#if OW_CFG_GROUP || __DOXYGEN__
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         OW
+ * \defgroup        OW_GROUP Multi-bus group
+ * \brief           Parallel enumeration and polling of many buses with worker pool
+ * \{
+ *
+ * Group aggregates many 1-Wire buses, such as multiple UART adapters on single gateway.
+ * Each operation is split to one job per bus. Jobs are distributed to worker threads,
+ * each worker owns one bus at a time. Worker, which runs out of jobs,
+ * steals pending jobs of other workers, so buses with many devices do not delay the group.
+ * Results of all buses are merged to single array.
+ */
+
+struct ow_group;
+
+/**
+ * \brief           Single bus of the group
+ */
+typedef struct {
+    ow_t* ow;                                   /*!< 1-Wire handle */
+    ow_rom_t* rom_ids;                          /*!< Devices of the bus, filled by \ref ow_group_scan */
+    size_t rom_len;                             /*!< Number of entries in `rom_ids` array */
+    size_t rom_count;                           /*!< Number of valid entries in `rom_ids` array */
+    owr_t status;                               /*!< Result of last job */
+    uint32_t time;                              /*!< Duration of last job in units of milliseconds */
+    uint16_t worker;                            /*!< Index of worker, which executed last job */
+} ow_group_bus_t;
+
+/**
+ * \brief           Single entry of merged results
+ */
+typedef struct {
+    uint16_t bus;                               /*!< Index of bus in the group */
+    ow_rom_t rom;                               /*!< 1-Wire device address */
+    owr_t status;                               /*!< Device status, \ref owOK when `value` is valid */
+    int32_t value;                              /*!< Raw value, temperature in units of `1/16` degree Celsius for `DS18x20` */
+} ow_group_result_t;
+
+/**
+ * \brief           Job function, executed once for each bus
+ * \param[in]       group: Group handle
+ * \param[in]       bus: Bus to process, bus is locked. Use `_raw` functions only
+ * \param[in]       arg: User argument
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+typedef owr_t (*ow_group_job_fn)(struct ow_group* const group, ow_group_bus_t* const bus, void* arg);
+
+/**
+ * \brief           Group handle
+ */
+typedef struct ow_group {
+    ow_group_bus_t* buses;                      /*!< Array of buses */
+    size_t bus_count;                           /*!< Number of buses */
+    size_t worker_count;                        /*!< Number of worker threads */
+    ow_group_result_t* results;                 /*!< Array of merged results */
+    size_t result_len;                          /*!< Number of entries in `results` array */
+    atomic_size_t result_count;                 /*!< Number of results of last operation, may exceed `result_len` */
+    uint16_t queue[OW_CFG_GROUP_BUSES];         /*!< Bus indexes, each worker owns contiguous range */
+    atomic_uint_least32_t ranges[OW_CFG_GROUP_WORKERS]; /*!< Pending range of each worker, first index in low and end in high half-word */
+    atomic_uint_least32_t active;               /*!< Number of workers not finished with current operation */
+    uint32_t steals[OW_CFG_GROUP_WORKERS];      /*!< Number of jobs each worker has stolen in last operation */
+    ow_group_job_fn fn;                         /*!< Job function of current operation */
+    void* arg;                                  /*!< User argument for job function */
+    OW_CFG_OS_SEM_HANDLE start[OW_CFG_GROUP_WORKERS];   /*!< Semaphore to start each worker */
+    OW_CFG_OS_SEM_HANDLE done;                  /*!< Semaphore released by last worker to finish */
+    uint8_t stop;                               /*!< Set to `1` to stop worker threads */
+} ow_group_t;
+
+owr_t       ow_group_init(ow_group_t* const group, ow_group_bus_t* const buses, const size_t bus_count,
+                          const size_t worker_count, ow_group_result_t* const results, const size_t result_len);
+owr_t       ow_group_deinit(ow_group_t* const group);
+owr_t       ow_group_worker(ow_group_t* const group, const size_t index);
+owr_t       ow_group_stop(ow_group_t* const group);
+
+owr_t       ow_group_run(ow_group_t* const group, const ow_group_job_fn fn, void* const arg);
+owr_t       ow_group_scan(ow_group_t* const group);
+owr_t       ow_group_poll(ow_group_t* const group);
+owr_t       ow_group_add_result(ow_group_t* const group, const ow_group_bus_t* const bus, const ow_rom_t* const rom_id,
+                                const owr_t status, const int32_t value);
+size_t      ow_group_get_result_count(ow_group_t* const group);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_CFG_GROUP || __DOXYGEN__ */
+
+#endif /* OW_HDR_GROUP_H */
@@ -0,0 +1,143 @@
+/**
+ * \file            ow_sampler.h
+ * \brief           Periodic sampler header
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_SAMPLER_H
+#define OW_HDR_SAMPLER_H
+
+#include "ow/ow.h"
+
+#if OW_CFG_SAMPLER || __DOXYGEN__
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         OW
+ * \defgroup        OW_SAMPLER Periodic sampler
+ * \brief           Periodic acquisition with lock-free sample distribution
+ * \{
+ *
+ * Single thread acquires samples from all devices at configured rate
+ * and writes them to ring buffer. Any number of consumer threads read samples
+ * from the buffer, without accessing the bus or its mutex.
+ */
+
+/**
+ * \brief           Single timestamped sample
+ */
+typedef struct {
+    uint32_t tick;                              /*!< Time of measurement in units of milliseconds, see \ref ow_sys_get_tick */
+    uint16_t index;                             /*!< Index of device in ROM array */
+    owr_t status;                               /*!< Read status, \ref owOK when `value` is valid */
+    int32_t value;                              /*!< Raw value, temperature in units of `1/16` degree Celsius for `DS18x20` */
+} ow_sample_t;
+
+/**
+ * \brief           Ring buffer slot
+ */
+typedef struct {
+    atomic_uint_least32_t seq;                  /*!< Sequence number, odd while slot is written */
+    ow_sample_t sample;                         /*!< Sample data */
+} ow_sampler_slot_t;
+
+/**
+ * \brief           Function called once per cycle, before devices are read
+ * \param[in]       ow: 1-Wire handle, bus is locked
+ * \param[in]       arg: User argument
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+typedef owr_t (*ow_sampler_start_fn)(ow_t* const ow, void* arg);
+
+/**
+ * \brief           Function to read value of single device
+ * \param[in]       ow: 1-Wire handle, bus is locked
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[out]      value: Output variable to save raw value
+ * \param[in]       arg: User argument
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+typedef owr_t (*ow_sampler_read_fn)(ow_t* const ow, const ow_rom_t* const rom_id, int32_t* const value, void* arg);
+
+/**
+ * \brief           Sampler handle
+ */
+typedef struct {
+    ow_t* ow;                                   /*!< 1-Wire handle */
+    const ow_rom_t* rom_ids;                    /*!< Array of devices to sample */
+    size_t rom_len;                             /*!< Number of devices */
+    uint32_t period;                            /*!< Sample period in units of milliseconds */
+    ow_sampler_start_fn start_fn;               /*!< Cycle start function */
+    ow_sampler_read_fn read_fn;                 /*!< Device read function */
+    void* arg;                                  /*!< User argument for functions */
+    ow_sampler_slot_t* slots;                   /*!< Ring buffer slots */
+    uint32_t mask;                              /*!< Ring buffer size minus `1` */
+    atomic_uint_least32_t head;                 /*!< Number of samples written since start */
+    uint32_t next_tick;                         /*!< Scheduled time of next cycle */
+    uint32_t cycles;                            /*!< Number of completed cycles */
+    uint32_t overruns;                          /*!< Number of periods missed because cycle took too long */
+    uint32_t jitter_last;                       /*!< Start delay of last cycle in units of milliseconds */
+    uint32_t jitter_max;                        /*!< Maximal start delay of cycle in units of milliseconds */
+} ow_sampler_t;
+
+/**
+ * \brief           Sampler consumer handle, one for each consumer thread
+ */
+typedef struct {
+    ow_sampler_t* sampler;                      /*!< Sampler to read from */
+    uint32_t tail;                              /*!< Index of next sample to read */
+    uint32_t lost;                              /*!< Number of samples overwritten before read */
+} ow_sampler_reader_t;
+
+owr_t       ow_sampler_init(ow_sampler_t* const sampler, ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len,
+                            const uint32_t period, ow_sampler_slot_t* const slots, const size_t slot_count);
+owr_t       ow_sampler_set_functions(ow_sampler_t* const sampler, const ow_sampler_start_fn start_fn,
+                                     const ow_sampler_read_fn read_fn, void* const arg);
+owr_t       ow_sampler_step(ow_sampler_t* const sampler, uint32_t* const next_ms);
+owr_t       ow_sampler_run(ow_sampler_t* const sampler, const uint32_t duration);
+
+owr_t       ow_sampler_reader_init(ow_sampler_reader_t* const reader, ow_sampler_t* const sampler);
+uint8_t     ow_sampler_read(ow_sampler_reader_t* const reader, ow_sample_t* const sample);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_CFG_SAMPLER || __DOXYGEN__ */
+
+#endif /* OW_HDR_SAMPLER_H */
@@ -0,0 +1,116 @@
+/**
+ * \file            ow_worker.h
+ * \brief           Bus worker header
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_WORKER_H
+#define OW_HDR_WORKER_H
+
+#include "ow/ow.h"
+
+#if OW_CFG_WORKER || __DOXYGEN__
+#include <stdatomic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         OW
+ * \defgroup        OW_WORKER Bus worker
+ * \brief           Dedicated bus thread with lock-free request queue
+ * \{
+ *
+ * Single worker thread owns the bus. Other threads submit operations to the worker
+ * through lock-free multi-producer queue and wait for their completion,
+ * instead of locking the bus with \ref ow_protect.
+ * Worker executes queued operations back to back, bus is locked once per batch.
+ */
+
+/**
+ * \brief           Operation function, executed by worker thread
+ * \param[in]       ow: 1-Wire handle, bus is locked. Use `_raw` functions only
+ * \param[in]       arg: User argument
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+typedef owr_t (*ow_work_fn)(ow_t* const ow, void* arg);
+
+/**
+ * \brief           Single operation request
+ *
+ * Request is owned by submitting thread and may be reused after completion
+ */
+typedef struct ow_work {
+    _Atomic(struct ow_work*) next;              /*!< Next request in queue */
+    ow_work_fn fn;                              /*!< Operation function */
+    void* arg;                                  /*!< User argument for function */
+    owr_t res;                                  /*!< Operation result, valid after completion */
+    OW_CFG_OS_SEM_HANDLE done;                  /*!< Completion semaphore */
+} ow_work_t;
+
+/**
+ * \brief           Worker handle
+ */
+typedef struct {
+    ow_t* ow;                                   /*!< 1-Wire handle owned by worker */
+    _Atomic(ow_work_t*) head;                   /*!< Last queued request, producers append here */
+    ow_work_t* tail;                            /*!< Next request to execute, used by worker only */
+    ow_work_t stub;                             /*!< Queue placeholder, queue is never empty */
+    atomic_uint_least32_t pending;              /*!< Number of submitted and not yet completed requests,
+                                                        top bit is set when worker is stopped */
+    OW_CFG_OS_SEM_HANDLE sem;                   /*!< Semaphore to wake up worker thread when first request is submitted */
+    uint8_t stop;                               /*!< Set to `1` by stop request, used by worker only */
+    uint32_t processed;                         /*!< Number of executed requests */
+    uint32_t batches;                           /*!< Number of bus lock periods */
+} ow_worker_t;
+
+owr_t       ow_worker_init(ow_worker_t* const worker, ow_t* const ow);
+owr_t       ow_worker_deinit(ow_worker_t* const worker);
+owr_t       ow_worker_run(ow_worker_t* const worker);
+owr_t       ow_worker_stop(ow_worker_t* const worker, ow_work_t* const work);
+
+owr_t       ow_work_init(ow_work_t* const work, void* const arg);
+owr_t       ow_work_deinit(ow_work_t* const work, void* const arg);
+owr_t       ow_worker_submit(ow_worker_t* const worker, ow_work_t* const work, const ow_work_fn fn, void* const arg);
+owr_t       ow_worker_wait(ow_worker_t* const worker, ow_work_t* const work);
+owr_t       ow_worker_call(ow_worker_t* const worker, ow_work_t* const work, const ow_work_fn fn, void* const arg);
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_CFG_WORKER || __DOXYGEN__ */
+
+#endif /* OW_HDR_WORKER_H */
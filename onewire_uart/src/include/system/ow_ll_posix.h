@@ -0,0 +1,109 @@
+/**
+ * \file            ow_ll_posix.h
+ * \brief           UART driver for POSIX serial ports with Linux event loop
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_LL_POSIX_H
+#define OW_HDR_LL_POSIX_H
+
+#include "ow/ow.h"
+#include "ow/ow_async.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         OW_ASYNC
+ * \defgroup        OW_LL_POSIX POSIX serial port driver
+ * \brief           Serial port driver and `epoll` event loop for Linux
+ * \{
+ *
+ * Driver uses non-blocking terminal device of each bus. It implements blocking `tx_rx`
+ * for regular API and non-blocking `tx_start` and `rx_read` for \ref OW_ASYNC module.
+ * Event loop waits on all registered buses with single `epoll` call
+ * and advances transaction of each bus that received data.
+ */
+
+/**
+ * \brief           Time without received data after which transfer is aborted,
+ *                  in units of milliseconds
+ */
+#ifndef OW_LL_POSIX_TIMEOUT
+#define OW_LL_POSIX_TIMEOUT                     100
+#endif
+
+/**
+ * \brief           Serial port of single bus, used as argument of \ref ow_init function
+ */
+typedef struct {
+    const char* path;                           /*!< Path of terminal device, for example `/dev/ttyUSB0` */
+    int fd;                                     /*!< File descriptor, valid after initialization */
+} ow_ll_posix_t;
+
+extern const ow_ll_drv_t ow_ll_drv_posix;
+
+uint32_t    ow_ll_posix_get_time(void);
+
+#if OW_CFG_ASYNC || __DOXYGEN__
+
+/**
+ * \brief           Maximal number of buses in single event loop
+ */
+#ifndef OW_LL_POSIX_LOOP_BUSES
+#define OW_LL_POSIX_LOOP_BUSES                  32
+#endif
+
+/**
+ * \brief           Event loop handle
+ */
+typedef struct {
+    int epfd;                                   /*!< `epoll` file descriptor */
+    ow_async_t* buses[OW_LL_POSIX_LOOP_BUSES];  /*!< Registered buses */
+    size_t bus_count;                           /*!< Number of registered buses */
+} ow_ll_posix_loop_t;
+
+owr_t       ow_ll_posix_loop_init(ow_ll_posix_loop_t* const loop);
+owr_t       ow_ll_posix_loop_deinit(ow_ll_posix_loop_t* const loop);
+owr_t       ow_ll_posix_loop_add(ow_ll_posix_loop_t* const loop, ow_async_t* const async);
+owr_t       ow_ll_posix_loop_run(ow_ll_posix_loop_t* const loop, const uint32_t timeout);
+
+#endif /* OW_CFG_ASYNC || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_HDR_LL_POSIX_H */
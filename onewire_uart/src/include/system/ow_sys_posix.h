@@ -0,0 +1,136 @@
+/**
+ * \file            ow_sys_posix.h
+ * \brief           System functions for POSIX with real-time profile for Linux
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_SYS_POSIX_H
+#define OW_HDR_SYS_POSIX_H
+
+#include "ow/ow.h"
+#if OW_CFG_WORKER
+#include "ow/ow_worker.h"
+#endif /* OW_CFG_WORKER */
+
+#if OW_CFG_OS || __DOXYGEN__
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/**
+ * \ingroup         OW_SYS
+ * \defgroup        OW_SYS_POSIX POSIX system functions
+ * \brief           System functions with `pthread` library and real-time profile for Linux
+ * \{
+ *
+ * Real-time profile is opt-in. Memory of the process is locked and prefaulted once at startup,
+ * bus threads then run with `SCHED_FIFO` policy, pinned to selected CPU.
+ * Jitter monitor records latency of each transaction, executed by bus worker,
+ * to histograms with fixed bins.
+ */
+
+/**
+ * \brief           Number of histogram bins, latencies above the last bin are counted as overflow
+ */
+#ifndef OW_SYS_POSIX_HIST_BINS
+#define OW_SYS_POSIX_HIST_BINS                  32
+#endif
+
+/**
+ * \brief           Real-time profile of single thread
+ */
+typedef struct {
+    int priority;                               /*!< `SCHED_FIFO` priority, between `1` and `99`.
+                                                        Set to `0` to keep default scheduling policy */
+    int cpu;                                    /*!< CPU to pin thread to. Set to `-1` to run on any CPU */
+} ow_sys_posix_rt_t;
+
+/**
+ * \brief           Latency histogram
+ */
+typedef struct {
+    uint32_t bin_us;                            /*!< Width of single bin in units of microseconds */
+    uint32_t bins[OW_SYS_POSIX_HIST_BINS];      /*!< Number of samples in each bin */
+    uint32_t overflow;                          /*!< Number of samples above the last bin */
+    uint32_t count;                             /*!< Number of all samples */
+    uint32_t min_us;                            /*!< Lowest sample in units of microseconds */
+    uint32_t max_us;                            /*!< Highest sample in units of microseconds */
+    uint64_t total_us;                          /*!< Sum of all samples in units of microseconds */
+} ow_sys_posix_hist_t;
+
+uint32_t    ow_sys_posix_get_time_us(void);
+owr_t       ow_sys_posix_rt_lock_memory(const size_t stack_size, const size_t heap_size);
+owr_t       ow_sys_posix_rt_setup(const ow_sys_posix_rt_t* const rt);
+
+owr_t       ow_sys_posix_hist_init(ow_sys_posix_hist_t* const hist, const uint32_t bin_us);
+owr_t       ow_sys_posix_hist_add(ow_sys_posix_hist_t* const hist, const uint32_t us);
+uint32_t    ow_sys_posix_hist_get_percentile(const ow_sys_posix_hist_t* const hist, const uint8_t percent);
+
+#if OW_CFG_WORKER || __DOXYGEN__
+
+/**
+ * \brief           Jitter monitor of bus worker
+ */
+typedef struct {
+    ow_sys_posix_hist_t wait;                   /*!< Time from submission to start of execution,
+                                                        covers queueing and thread wake-up latency */
+    ow_sys_posix_hist_t exec;                   /*!< Execution time of operation function */
+} ow_sys_posix_monitor_t;
+
+/**
+ * \brief           Bus worker thread with real-time profile
+ */
+typedef struct {
+    ow_worker_t* worker;                        /*!< Worker to run */
+    ow_sys_posix_rt_t rt;                       /*!< Real-time profile of worker thread */
+    owr_t res;                                  /*!< Result of profile setup or worker, valid after thread exits */
+} ow_sys_posix_worker_t;
+
+void*       ow_sys_posix_worker_thread(void* arg);
+owr_t       ow_sys_posix_monitor_init(ow_sys_posix_monitor_t* const monitor, const uint32_t bin_us);
+owr_t       ow_sys_posix_monitor_call(ow_worker_t* const worker, ow_work_t* const work, ow_sys_posix_monitor_t* const monitor,
+                                      const ow_work_fn fn, void* const arg);
+owr_t       ow_sys_posix_monitor_get(ow_worker_t* const worker, ow_work_t* const work, ow_sys_posix_monitor_t* const monitor,
+                                     ow_sys_posix_monitor_t* const out, const uint8_t clear);
+
+#endif /* OW_CFG_WORKER || __DOXYGEN__ */
+
+/**
+ * \}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
+#endif /* OW_HDR_SYS_POSIX_H */
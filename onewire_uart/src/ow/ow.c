@@ -42,11 +42,104 @@
 
 #define OW_RESET_BYTE                   0xF0
 
+#if OW_CFG_DEADLINE && !OW_CFG_OS
+#error "OW_CFG_OS must be enabled to use deadlines"
+#endif /* OW_CFG_DEADLINE && !OW_CFG_OS */
+
+#if OW_CFG_ARBITER
+#if !OW_CFG_OS
+#error "OW_CFG_OS must be enabled to use arbiter"
+#endif /* !OW_CFG_OS */
+
+/* Thread waiting for the bus, allocated on its stack */
+typedef struct ow_arb_waiter {
+    struct ow_arb_waiter* next;                 /* Next waiting thread with same or lower priority */
+    uint8_t prio;                               /* Priority of waiting thread */
+    uint8_t granted;                            /* Set to `1` when bus is passed to this thread */
+    OW_CFG_OS_SEM_HANDLE sem;                   /* Semaphore to wake up waiting thread */
+} ow_arb_waiter_t;
+#endif /* OW_CFG_ARBITER */
+
 #endif /* !__DOXYGEN__ */
 
 /* Set value if not NULL */
 #define SET_NOT_NULL(p, v)          if ((p) != NULL) { *(p) = (v); }
 
+#if OW_CFG_CANCEL || __DOXYGEN__
+
+/**
+ * \brief           Check attached cancellation token
+ *
+ * When cancellation is requested, reset pulse is sent once, directly with low-level driver.
+ * Devices abandon partially executed command and bus is left in idle state
+ *
+ * \param[in]       ow: OneWire instance
+ * \return          \ref owERRCANCEL when cancellation is requested, \ref owOK otherwise
+ */
+static owr_t
+prv_check_cancel(ow_t* const ow) {
+    uint8_t b = OW_RESET_BYTE;
+
+    if (ow->cancel == NULL || !ow_cancel_is_set(ow->cancel)) {
+        ow->cancel_reset = 0;
+        return owOK;
+    }
+    if (!ow->cancel_reset) {
+        ow->cancel_reset = 1;
+        if (ow->ll_drv->set_baudrate(OW_BAUD_RESET, ow->arg)) {
+            ow->ll_drv->tx_rx(&b, &b, 1, ow->arg);
+        }
+        ow->ll_drv->set_baudrate(OW_BAUD_DATA, ow->arg);
+    }
+    return owERRCANCEL;
+}
+
+#endif /* OW_CFG_CANCEL || __DOXYGEN__ */
+
+/**
+ * \brief           Exchange data with low-level driver
+ *
+ * All bus transfers go through this function. When deadline is armed,
+ * remaining time is checked before transfer and passed to low-level driver.
+ * When cancellation token is attached, it is checked before transfer
+ *
+ * \param[in]       ow: OneWire instance
+ * \param[in]       tx: Data to transmit
+ * \param[out]      rx: Array to write received data to
+ * \param[in]       len: Number of bytes to exchange
+ * \return          \ref owOK on success, \ref owERRTIMEOUT when deadline expired,
+ *                      \ref owERRCANCEL when cancelled, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_tx_rx(ow_t* const ow, const uint8_t* tx, uint8_t* rx, const size_t len) {
+#if OW_CFG_CANCEL
+    owr_t res;
+
+    if ((res = prv_check_cancel(ow)) != owOK) {
+        return res;
+    }
+#endif /* OW_CFG_CANCEL */
+#if OW_CFG_DEADLINE
+    if (ow->deadline_set) {
+        uint32_t remaining;
+
+        if ((remaining = ow_get_deadline_remaining_raw(ow)) == 0) {
+            return owERRTIMEOUT;
+        }
+        if (ow->ll_drv->tx_rx_timeout != NULL) {
+            if (!ow->ll_drv->tx_rx_timeout(tx, rx, len, remaining, ow->arg)) {
+                return ow_get_deadline_remaining_raw(ow) == 0 ? owERRTIMEOUT : owERRTXRX;
+            }
+            return owOK;
+        }
+    }
+#endif /* OW_CFG_DEADLINE */
+    if (!ow->ll_drv->tx_rx(tx, rx, len, ow->arg)) {
+        return owERRTXRX;
+    }
+    return owOK;
+}
+
 /**
  * \brief           Send single bit to OneWire port
  * \param[in]       ow: OneWire instance
@@ -57,6 +150,7 @@
 static owr_t
 send_bit(ow_t* const ow, uint8_t btw, uint8_t* btr) {
     uint8_t b;
+    owr_t res;
 
     SET_NOT_NULL(btr, 0);
 
@@ -65,8 +159,8 @@ send_bit(ow_t* const ow, uint8_t btw, uint8_t* btr) {
      * To send logical 0 over 1-wire, send 0x00 over UART
      */
     btw = btw > 0 ? 0xFF : 0x00;                /* Convert to 0 or 1 */
-    if (!ow->ll_drv->tx_rx(&btw, &b, 1, ow->arg)) {
-        return owERRTXRX;                       /* Transmit error */
+    if ((res = prv_tx_rx(ow, &btw, &b, 1)) != owOK) {
+        return res;                             /* Transmit error */
     }
     b = b == 0xFF ? 1 : 0;                      /* Go to bit values */
     SET_NOT_NULL(btr, b);                       /* Set new byte */
@@ -91,6 +185,10 @@ ow_init(ow_t* const ow, const ow_ll_drv_t* const ll_drv, void* arg) {
 
     ow->arg = arg;
     ow->ll_drv = ll_drv;                        /* Assign low-level driver */
+#if OW_CFG_DS18X20_CACHE
+    ow->ds18x20_cache = NULL;                   /* No cache attached by default */
+    ow->ds18x20_cache_len = 0;
+#endif /* OW_CFG_DS18X20_CACHE */
     if (!ow->ll_drv->init(ow->arg)) {           /* Init low-level directly */
         return owERR;
     }
@@ -100,6 +198,23 @@ ow_init(ow_t* const ow, const ow_ll_drv_t* const ll_drv, void* arg) {
         return owERR;
     }
 #endif /* OW_CFG_OS */
+#if OW_CFG_DEADLINE
+    ow->deadline_set = 0;
+#endif /* OW_CFG_DEADLINE */
+#if OW_CFG_CANCEL
+    ow->cancel = NULL;
+    ow->cancel_reset = 0;
+#endif /* OW_CFG_CANCEL */
+#if OW_CFG_ARBITER
+    ow->arb_waiters = NULL;
+    ow->arb_busy = 0;
+    memset(ow->arb_stats, 0x00, sizeof(ow->arb_stats));
+    if (!ow_sys_mutex_create(&ow->arb_mutex, arg)) {
+        ow_sys_mutex_delete(&ow->mutex, arg);
+        ow->ll_drv->deinit(ow->arg);            /* Deinit low-level */
+        return owERR;
+    }
+#endif /* OW_CFG_ARBITER */
     return owOK;
 }
 
@@ -116,6 +231,9 @@ ow_deinit(ow_t* const ow) {
 #if OW_CFG_OS
     ow_sys_mutex_delete(&ow->mutex, ow->arg);
 #endif /* OW_CFG_OS */
+#if OW_CFG_ARBITER
+    ow_sys_mutex_delete(&ow->arb_mutex, ow->arg);
+#endif /* OW_CFG_ARBITER */
     ow->ll_drv->deinit(ow->arg);
 }
 
@@ -163,6 +281,440 @@ ow_unprotect(ow_t* const ow, const uint8_t protect) {
     return owOK;
 }
 
+#if OW_CFG_ARBITER || __DOXYGEN__
+
+/**
+ * \brief           Pass the bus to waiting thread with highest priority or mark it free
+ * \param[in,out]   ow: 1-Wire handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_arb_handoff(ow_t* const ow) {
+    ow_arb_waiter_t* w;
+
+    if (!ow_sys_mutex_wait(&ow->arb_mutex, ow->arg)) {
+        return owERR;
+    }
+    if ((w = ow->arb_waiters) != NULL) {        /* Bus stays busy and changes owner */
+        ow->arb_waiters = w->next;
+        w->granted = 1;
+        ow_sys_sem_release(&w->sem, ow->arg);
+    } else {
+        ow->arb_busy = 0;
+    }
+    ow_sys_mutex_release(&ow->arb_mutex, ow->arg);
+    return owOK;
+}
+
+/**
+ * \brief           Acquire the bus with priority
+ *
+ * When bus is busy, calling thread waits in queue ordered by priority.
+ * On release, bus is passed directly to waiting thread with highest priority,
+ * threads with the same priority are served in order of arrival.
+ * Waiting time of each acquisition is recorded in statistics of its priority class.
+ *
+ * After bus is granted, bus mutex is locked too. Thread-safe functions may be called
+ * by the owner, functions with `_raw` suffix are used as with \ref ow_protect.
+ *
+ * \note            Only threads using this function are ordered by priority.
+ *                  Thread-safe functions called without it wait for bus mutex directly
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       prio: Priority of calling thread, from `0` (lowest) to \ref OW_CFG_ARBITER_PRIOS `- 1`.
+ *                      Use one of `OW_PRIO_*` values
+ * \param[in]       timeout: Maximal time to wait for the bus in units of milliseconds.
+ *                      Set to `0` to wait forever
+ * \return          \ref owOK when bus is granted, \ref owERRTIMEOUT when it was not granted in time,
+ *                      member of \ref owr_t otherwise. When bus mutex cannot be locked after
+ *                      bus is granted, bus is passed on as with \ref ow_unprotect_ex
+ */
+owr_t
+ow_protect_ex(ow_t* const ow, const uint8_t prio, const uint32_t timeout) {
+    ow_arb_waiter_t w, **pp;
+    ow_arb_stats_t* st;
+    uint32_t start, waited;
+    uint8_t ok;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("prio < OW_CFG_ARBITER_PRIOS", prio < OW_CFG_ARBITER_PRIOS);
+
+    st = &ow->arb_stats[prio];
+    if (!ow_sys_mutex_wait(&ow->arb_mutex, ow->arg)) {
+        return owERR;
+    }
+    if (!ow->arb_busy) {                        /* Bus is free, take it immediately */
+        ow->arb_busy = 1;
+        ++st->count;
+        ow_sys_mutex_release(&ow->arb_mutex, ow->arg);
+        if ((res = ow_protect(ow, 1)) != owOK) {
+            prv_arb_handoff(ow);                /* Do not keep the bus without owner */
+        }
+        return res;
+    }
+
+    /* Insert behind waiting threads with the same or higher priority */
+    if (!ow_sys_sem_create(&w.sem, ow->arg)) {
+        ow_sys_mutex_release(&ow->arb_mutex, ow->arg);
+        return owERR;
+    }
+    w.prio = prio;
+    w.granted = 0;
+    for (pp = &ow->arb_waiters; *pp != NULL && (*pp)->prio >= prio; pp = &(*pp)->next) {}
+    w.next = *pp;
+    *pp = &w;
+    start = ow_sys_get_tick(ow->arg);
+    ow_sys_mutex_release(&ow->arb_mutex, ow->arg);
+
+    ok = ow_sys_sem_wait(&w.sem, timeout, ow->arg);
+
+    /* Bus may be granted at the same time as wait times out */
+    ow_sys_mutex_wait(&ow->arb_mutex, ow->arg);
+    if (!ok && !w.granted) {
+        for (pp = &ow->arb_waiters; *pp != &w; pp = &(*pp)->next) {}
+        *pp = w.next;                           /* Remove from waiting list */
+        ++st->timeouts;
+    } else {
+        waited = ow_sys_get_tick(ow->arg) - start;
+        ++st->count;
+        ++st->contended;
+        st->wait_total += waited;
+        if (waited > st->wait_max) {
+            st->wait_max = waited;
+        }
+    }
+    ow_sys_mutex_release(&ow->arb_mutex, ow->arg);
+    ow_sys_sem_delete(&w.sem, ow->arg);
+    if (!w.granted) {
+        return owERRTIMEOUT;
+    }
+    if ((res = ow_protect(ow, 1)) != owOK) {
+        prv_arb_handoff(ow);                    /* Do not keep the bus without owner */
+    }
+    return res;
+}
+
+/**
+ * \brief           Release the bus acquired with \ref ow_protect_ex
+ *
+ * Bus is passed to waiting thread with highest priority, if any
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_unprotect_ex(ow_t* const ow) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    res = ow_unprotect(ow, 1);
+    if (prv_arb_handoff(ow) != owOK) {
+        return owERR;
+    }
+    return res;
+}
+
+/**
+ * \brief           Get bus wait time statistics of priority class
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       prio: Priority class
+ * \param[out]      stats: Output variable to save statistics to
+ * \param[in]       clear: Set to `1` to clear statistics after they are read
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_get_arb_stats(ow_t* const ow, const uint8_t prio, ow_arb_stats_t* const stats, const uint8_t clear) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("prio < OW_CFG_ARBITER_PRIOS", prio < OW_CFG_ARBITER_PRIOS);
+    OW_ASSERT("stats != NULL", stats != NULL);
+
+    if (!ow_sys_mutex_wait(&ow->arb_mutex, ow->arg)) {
+        return owERR;
+    }
+    *stats = ow->arb_stats[prio];
+    if (clear) {
+        memset(&ow->arb_stats[prio], 0x00, sizeof(ow->arb_stats[prio]));
+    }
+    ow_sys_mutex_release(&ow->arb_mutex, ow->arg);
+    return owOK;
+}
+
+#endif /* OW_CFG_ARBITER || __DOXYGEN__ */
+
+#if OW_CFG_DEADLINE || __DOXYGEN__
+
+/**
+ * \brief           Acquire the bus and arm deadline for all following operations
+ *
+ * Time to acquire the bus is part of the budget. Until \ref ow_unprotect_deadline is called,
+ * each transfer checks remaining time and passes it to low-level driver.
+ * Operations of the owner, thread-safe or `_raw`, abort with \ref owERRTIMEOUT
+ * when deadline expires. Bus is left in unknown state and must be reset before next command.
+ *
+ * \code{c}
+if (ow_protect_deadline(&ow, 1000) == owOK) {
+    ow_ds18x20_start_raw(&ow, NULL);
+    res = ow_ds18x20_wait_raw(&ow, 12);
+    ow_unprotect_deadline(&ow);
+    if (res == owERRTIMEOUT) {
+        //Conversion did not complete in 1 second
+    }
+}
+\endcode
+ *
+ * \note            Deadlines do not nest. Arming new deadline replaces previous one
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       timeout: Time budget in units of milliseconds, must be greater than `0`
+ * \return          \ref owOK when bus is acquired, \ref owERRTIMEOUT when it was not acquired in time,
+ *                      member of \ref owr_t otherwise
+ */
+owr_t
+ow_protect_deadline(ow_t* const ow, const uint32_t timeout) {
+    uint32_t start;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("timeout > 0", timeout > 0);
+
+    start = ow_sys_get_tick(ow->arg);
+    if (!ow_sys_mutex_wait_timeout(&ow->mutex, timeout, ow->arg)) {
+        return owERRTIMEOUT;
+    }
+    ow->deadline = start + timeout;
+    ow->deadline_set = 1;
+    return owOK;
+}
+
+/**
+ * \brief           Disarm deadline and release the bus acquired with \ref ow_protect_deadline
+ * \param[in,out]   ow: 1-Wire handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_unprotect_deadline(ow_t* const ow) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow->deadline_set = 0;
+    return ow_unprotect(ow, 1);
+}
+
+/**
+ * \brief           Arm deadline without bus locking
+ *
+ * Used when bus is already owned by calling thread,
+ * such as in \ref ow_protect_ex period or in bus worker operation
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       timeout: Time budget from now in units of milliseconds, must be greater than `0`
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_set_deadline_raw(ow_t* const ow, const uint32_t timeout) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("timeout > 0", timeout > 0);
+
+    ow->deadline = ow_sys_get_tick(ow->arg) + timeout;
+    ow->deadline_set = 1;
+    return owOK;
+}
+
+/**
+ * \brief           Disarm deadline without bus locking
+ * \param[in,out]   ow: 1-Wire handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_clear_deadline_raw(ow_t* const ow) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow->deadline_set = 0;
+    return owOK;
+}
+
+/**
+ * \brief           Get remaining time of armed deadline
+ * \param[in]       ow: 1-Wire handle
+ * \return          Remaining time in units of milliseconds, `0` when deadline expired,
+ *                      `UINT32_MAX` when deadline is not armed
+ */
+uint32_t
+ow_get_deadline_remaining_raw(ow_t* const ow) {
+    int32_t diff;
+
+    OW_ASSERT0("ow != NULL", ow != NULL);
+
+    if (!ow->deadline_set) {
+        return UINT32_MAX;
+    }
+    diff = (int32_t)(ow->deadline - ow_sys_get_tick(ow->arg));
+    return diff > 0 ? (uint32_t)diff : 0;
+}
+
+#endif /* OW_CFG_DEADLINE || __DOXYGEN__ */
+
+#if OW_CFG_CANCEL || __DOXYGEN__
+
+/**
+ * \brief           Initialize cancellation token, not set
+ * \param[out]      token: Cancellation token
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_cancel_init(ow_cancel_t* const token) {
+    OW_ASSERT("token != NULL", token != NULL);
+
+    atomic_init(&token->set, 0);
+    return owOK;
+}
+
+/**
+ * \brief           Request cancellation
+ *
+ * Operation in progress on the bus with attached token aborts with \ref owERRCANCEL
+ * before its next transfer, or within \ref OW_CFG_CANCEL_POLL milliseconds when it sleeps.
+ * Following operations fail immediately, until token is cleared with \ref ow_cancel_clear.
+ *
+ * \code{c}
+//At startup
+ow_cancel_init(&shutdown);
+ow_set_cancel(&ow, &shutdown);
+
+//In service thread, on shutdown. Enumeration in progress aborts after current bit
+ow_cancel(&shutdown);
+\endcode
+ *
+ * \param[in,out]   token: Cancellation token
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function does not block and may be called from any thread
+ */
+owr_t
+ow_cancel(ow_cancel_t* const token) {
+    OW_ASSERT("token != NULL", token != NULL);
+
+    atomic_store_explicit(&token->set, 1, memory_order_release);
+    return owOK;
+}
+
+/**
+ * \brief           Clear cancellation request, operations on the bus are allowed again
+ * \param[in,out]   token: Cancellation token
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function does not block and may be called from any thread
+ */
+owr_t
+ow_cancel_clear(ow_cancel_t* const token) {
+    OW_ASSERT("token != NULL", token != NULL);
+
+    atomic_store_explicit(&token->set, 0, memory_order_release);
+    return owOK;
+}
+
+/**
+ * \brief           Check if cancellation is requested
+ * \param[in]       token: Cancellation token
+ * \return          `1` when cancellation is requested, `0` otherwise
+ */
+uint8_t
+ow_cancel_is_set(ow_cancel_t* const token) {
+    OW_ASSERT0("token != NULL", token != NULL);
+
+    return atomic_load_explicit(&token->set, memory_order_acquire);
+}
+
+/**
+ * \brief           Attach cancellation token to the bus
+ *
+ * Token is checked before each transfer of the bus, that is between bits of search
+ * and between chunks of \ref OW_CFG_BATCH_BYTES bytes of bulk transfers,
+ * and periodically during sleep in \ref ow_delay_raw, such as while waiting for conversion.
+ * On first check after cancellation, reset pulse is sent and bus is left in idle state.
+ * Single token may be attached to many buses.
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       token: Cancellation token. Set to `NULL` to detach token
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_set_cancel_raw(ow_t* const ow, ow_cancel_t* const token) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow->cancel = token;
+    ow->cancel_reset = 0;
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_set_cancel_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_set_cancel(ow_t* const ow, ow_cancel_t* const token) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_set_cancel_raw(ow, token);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+#endif /* OW_CFG_CANCEL || __DOXYGEN__ */
+
+#if OW_CFG_OS || __DOXYGEN__
+
+/**
+ * \brief           Put thread to sleep while bus stays locked, within armed deadline
+ *
+ * When deadline expires before `ms`, thread sleeps only for remaining time.
+ * When cancellation token is attached, it is checked every \ref OW_CFG_CANCEL_POLL milliseconds
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       ms: Time to sleep in units of milliseconds
+ * \return          \ref owOK on success, \ref owERRTIMEOUT when deadline expired,
+ *                      \ref owERRCANCEL when cancelled, member of \ref owr_t otherwise
+ */
+owr_t
+ow_delay_raw(ow_t* const ow, const uint32_t ms) {
+    uint32_t sleep = ms;
+    owr_t res = owOK;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+#if OW_CFG_DEADLINE
+    if (ow->deadline_set) {
+        uint32_t remaining = ow_get_deadline_remaining_raw(ow);
+
+        if (remaining <= ms) {
+            sleep = remaining;
+            res = owERRTIMEOUT;
+        }
+    }
+#endif /* OW_CFG_DEADLINE */
+#if OW_CFG_CANCEL
+    if (ow->cancel != NULL) {
+        /* Sleep in steps, to notice cancellation in time */
+        for (uint32_t step; sleep > 0; sleep -= step) {
+            if (ow_cancel_is_set(ow->cancel)) {
+                return owERRCANCEL;
+            }
+            step = sleep < OW_CFG_CANCEL_POLL ? sleep : OW_CFG_CANCEL_POLL;
+            ow_sys_delay(step, ow->arg);
+        }
+        return ow_cancel_is_set(ow->cancel) ? owERRCANCEL : res;
+    }
+#endif /* OW_CFG_CANCEL */
+    if (sleep > 0) {
+        ow_sys_delay(sleep, ow->arg);
+    }
+    return res;
+}
+
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 /**
  * \brief           Reset 1-Wire bus and set connected devices to idle state
  * \param[in,out]   ow: 1-Wire handle
@@ -171,18 +723,20 @@ ow_unprotect(ow_t* const ow, const uint8_t protect) {
 owr_t
 ow_reset_raw(ow_t* const ow) {
     uint8_t b;
+    owr_t res;
 
     OW_ASSERT("ow != NULL", ow != NULL);
 
     /* First send reset pulse */
     b = OW_RESET_BYTE;                          /* Set reset sequence byte = 0xF0 */
-    if (!ow->ll_drv->set_baudrate(9600, ow->arg)) {
+    if (!ow->ll_drv->set_baudrate(OW_BAUD_RESET, ow->arg)) {
         return owERRBAUD;                       /* Error setting baudrate */
     }
-    if (!ow->ll_drv->tx_rx(&b, &b, 1, ow->arg)) {
-        return owERRTXRX;                       /* Error with data exchange */
+    if ((res = prv_tx_rx(ow, &b, &b, 1)) != owOK) {
+        ow->ll_drv->set_baudrate(OW_BAUD_DATA, ow->arg);    /* Leave bus at data rate also on expired deadline */
+        return res;                             /* Error with data exchange */
     }
-    if (!ow->ll_drv->set_baudrate(115200, ow->arg)) {
+    if (!ow->ll_drv->set_baudrate(OW_BAUD_DATA, ow->arg)) {
         return owERRBAUD;                       /* Error setting baudrate */
     }
 
@@ -219,6 +773,7 @@ ow_reset(ow_t* const ow) {
 owr_t
 ow_write_byte_ex_raw(ow_t* const ow, const uint8_t btw, uint8_t* const br) {
     uint8_t tr[8];
+    owr_t res;
 
     OW_ASSERT("ow != NULL", ow != NULL);
     SET_NOT_NULL(br, 0);
@@ -236,8 +791,8 @@ ow_write_byte_ex_raw(ow_t* const ow, const uint8_t btw, uint8_t* const br) {
      * Exchange data on UART level,
      * send single byte for each bit = 8 bytes
      */
-    if (!ow->ll_drv->tx_rx(tr, tr, 8, ow->arg)) {
-        return owERRTXRX;
+    if ((res = prv_tx_rx(ow, tr, tr, 8)) != owOK) {
+        return res;
     }
 
     /* Update output value */
@@ -341,6 +896,214 @@ ow_read_bit_ex(ow_t* const ow, uint8_t* const br) {
     return res;
 }
 
+/**
+ * \brief           Write single bit to OW device and read its response
+ *
+ * Devices wait indefinitely between time slots, which allows application
+ * to send a command bit-by-bit and complete it at exact moment with its last bit
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       btw: Bit to write, either `1` or `0`
+ * \param[out]      br: Pointer to save read value. Set to `NULL` if not used
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_write_bit_ex_raw(ow_t* const ow, const uint8_t btw, uint8_t* const br) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    return send_bit(ow, btw, br);
+}
+
+/**
+ * \copydoc         ow_write_bit_ex_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_write_bit_ex(ow_t* const ow, const uint8_t btw, uint8_t* const br) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_write_bit_ex_raw(ow, btw, br);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Write multiple bytes over OW and read their response
+ *
+ * Bytes are encoded in chunks of up to \ref OW_CFG_BATCH_BYTES bytes,
+ * each chunk is exchanged with single call to low-level `tx_rx` function
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       btw: Array of bytes to write
+ * \param[out]      br: Array to save read values. Set to `NULL` if not used
+ * \param[in]       len: Number of bytes to write
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_write_bytes_ex_raw(ow_t* const ow, const uint8_t* const btw, uint8_t* const br, const size_t len) {
+    uint8_t tr[8 * OW_CFG_BATCH_BYTES];
+    size_t chunk;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("btw != NULL", btw != NULL);
+
+    for (size_t off = 0; off < len; off += chunk) {
+        chunk = len - off;
+        if (chunk > OW_CFG_BATCH_BYTES) {
+            chunk = OW_CFG_BATCH_BYTES;
+        }
+
+        /* Prepare output data, 8 UART bytes for each byte, LSB first */
+        for (size_t i = 0; i < chunk; ++i) {
+            for (uint8_t j = 0; j < 8; ++j) {
+                tr[8 * i + j] = (btw[off + i] & (1 << j)) ? 0xFF : 0x00;
+            }
+        }
+
+        /* Exchange complete chunk at once */
+        if ((res = prv_tx_rx(ow, tr, tr, 8 * chunk)) != owOK) {
+            return res;
+        }
+
+        /* Update output values */
+        if (br != NULL) {
+            for (size_t i = 0; i < chunk; ++i) {
+                uint8_t r = 0;
+                for (uint8_t j = 0; j < 8; ++j) {
+                    if (tr[8 * i + j] == 0xFF) {
+                        r |= 0x01 << j;
+                    }
+                }
+                br[off + i] = r;
+            }
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_write_bytes_ex_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_write_bytes_ex(ow_t* const ow, const uint8_t* const btw, uint8_t* const br, const size_t len) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("btw != NULL", btw != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_write_bytes_ex_raw(ow, btw, br, len);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Read multiple bytes from OW device
+ *
+ * Bytes are read in chunks of up to \ref OW_CFG_BATCH_BYTES bytes,
+ * each chunk is exchanged with single call to low-level `tx_rx` function
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[out]      br: Array to save read values
+ * \param[in]       len: Number of bytes to read
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_read_bytes_ex_raw(ow_t* const ow, uint8_t* const br, const size_t len) {
+    uint8_t tr[8 * OW_CFG_BATCH_BYTES];
+    size_t chunk;
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("br != NULL", br != NULL);
+
+    for (size_t off = 0; off < len; off += chunk) {
+        chunk = len - off;
+        if (chunk > OW_CFG_BATCH_BYTES) {
+            chunk = OW_CFG_BATCH_BYTES;
+        }
+
+        /* Reading is done by sending all bits as 1 and checking if slave pulls line down */
+        memset(tr, 0xFF, 8 * chunk);
+        if ((res = prv_tx_rx(ow, tr, tr, 8 * chunk)) != owOK) {
+            return res;
+        }
+        for (size_t i = 0; i < chunk; ++i) {
+            uint8_t r = 0;
+            for (uint8_t j = 0; j < 8; ++j) {
+                if (tr[8 * i + j] == 0xFF) {
+                    r |= 0x01 << j;
+                }
+            }
+            br[off + i] = r;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_read_bytes_ex_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_read_bytes_ex(ow_t* const ow, uint8_t* const br, const size_t len) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("br != NULL", br != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_read_bytes_ex_raw(ow, br, len);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
+/**
+ * \brief           Enable or disable strong pullup on 1-Wire line
+ *
+ * Strong pullup supplies parasitically powered devices during temperature conversion
+ * or EEPROM write. It must be enabled immediately after command has been sent
+ * and disabled before next bus communication.
+ *
+ * \param[in,out]   ow: 1-Wire handle
+ * \param[in]       enable: Set to `1` to enable strong pullup, `0` to disable it
+ * \return          \ref owOK on success, \ref owERR if low-level driver does not support strong pullup,
+ *                  member of \ref owr_t otherwise
+ */
+owr_t
+ow_strong_pullup_raw(ow_t* const ow, const uint8_t enable) {
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    if (ow->ll_drv->strong_pullup == NULL) {
+        return owERR;                           /* Feature not supported by hardware */
+    }
+    if (!ow->ll_drv->strong_pullup(enable, ow->arg)) {
+        return owERRTXRX;
+    }
+    return owOK;
+}
+
+/**
+ * \copydoc         ow_strong_pullup_raw
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_strong_pullup(ow_t* const ow, const uint8_t enable) {
+    owr_t res;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    ow_protect(ow, 1);
+    res = ow_strong_pullup_raw(ow, enable);
+    ow_unprotect(ow, 1);
+    return res;
+}
+
 /**
  * \brief           Reset search
  * \param[in,out]   ow: 1-Wire handle
@@ -429,15 +1192,17 @@ ow_search_with_command_raw(ow_t* const ow, const uint8_t cmd, ow_rom_t* const ro
     }
 
     /* Step 2: Send search rom command for all devices on 1-Wire */
-    ow_write_byte_ex_raw(ow, cmd, NULL);        /* Start with search ROM command */
+    if ((res = ow_write_byte_ex_raw(ow, cmd, NULL)) != owOK) { /* Start with search ROM command */
+        return res;
+    }
     next_disrepancy = OW_LAST_DEV;              /* This is currently last device */
 
     for (id_bit_number = 64; id_bit_number > 0;) {
         uint8_t b, b_cpl;
         for (uint8_t j = 8; j > 0; --j, --id_bit_number) {
             /* Read first bit and its complimentary one */
-            if (send_bit(ow, 1, &b) != owOK || send_bit(ow, 1, &b_cpl) != owOK) {
-                return owERRTXRX;
+            if ((res = send_bit(ow, 1, &b)) != owOK || (res = send_bit(ow, 1, &b_cpl)) != owOK) {
+                return res;
             }
 
             /*
@@ -484,7 +1249,9 @@ ow_search_with_command_raw(ow_t* const ow, const uint8_t cmd, ow_rom_t* const ro
              * In case of "collision", we decide here which devices we will
              * continue to scan (binary tree)
              */
-            send_bit(ow, b, NULL);              /* Send bit you want to continue with */
+            if ((res = send_bit(ow, b, NULL)) != owOK) {    /* Send bit you want to continue with */
+                return res;
+            }
 
             /*
              * Because we shift down *id each iteration, we have to position bit value to the MSB position
@@ -525,20 +1292,15 @@ ow_search_with_command(ow_t* const ow, const uint8_t cmd, ow_rom_t* const rom_id
  */
 owr_t
 ow_match_rom_raw(ow_t* const ow, const ow_rom_t* const rom_id) {
+    uint8_t cmd[1 + sizeof(rom_id->rom)];
+
     OW_ASSERT("ow != NULL", ow != NULL);
     OW_ASSERT("rom_id != NULL", rom_id != NULL);
 
-    /* Write byte to match rom exactly */
-    if (ow_write_byte_ex_raw(ow, OW_CMD_MATCHROM, NULL) != owOK) {
-        return owERR;
-    }
-    for (uint8_t i = 0; i < 8; ++i) {           /* Send 8 bytes representing ROM address */
-        if (ow_write_byte_ex_raw(ow, rom_id->rom[i], NULL) != owOK) {   /* Send ROM bytes */
-            return owERR;
-        }
-    }
-
-    return owOK;
+    /* Match rom command, followed by 8 bytes representing ROM address */
+    cmd[0] = OW_CMD_MATCHROM;
+    memcpy(&cmd[1], rom_id->rom, sizeof(rom_id->rom));
+    return ow_write_bytes_ex_raw(ow, cmd, NULL, sizeof(cmd));
 }
 
 /**
@@ -547,7 +1309,7 @@ ow_match_rom_raw(ow_t* const ow, const ow_rom_t* const rom_id) {
  */
 owr_t
 ow_match_rom(ow_t* const ow, const ow_rom_t* const rom_id) {
-    uint8_t res;
+    owr_t res;
 
     OW_ASSERT("ow != NULL", ow != NULL);
     OW_ASSERT("rom_id != NULL", rom_id != NULL);
@@ -617,6 +1379,29 @@ ow_crc(const void* in, const size_t len) {
     return crc;
 }
 
+/**
+ * \brief           Get time to transfer data on 1-Wire bus
+ *
+ * Reset pulse is single UART byte at \ref OW_BAUD_RESET,
+ * each 1-Wire byte is sent as `8` UART bytes at \ref OW_BAUD_DATA.
+ * Every UART byte takes `10` bits, including start and stop bit.
+ *
+ * \note            Low-level driver overhead, such as baudrate change, is not included
+ *
+ * \param[in]       resets: Number of reset pulses
+ * \param[in]       bytes: Number of written and read bytes
+ * \return          Transfer time in units of microseconds, rounded up
+ * \note            This function is reentrant
+ */
+uint32_t
+ow_get_transfer_time(const size_t resets, const size_t bytes) {
+    uint64_t num;
+
+    num = (uint64_t)resets * 10U * 1000000U * OW_BAUD_DATA
+        + (uint64_t)bytes * 8U * 10U * 1000000U * OW_BAUD_RESET;
+    return (uint32_t)((num + (uint64_t)OW_BAUD_RESET * OW_BAUD_DATA - 1) / ((uint64_t)OW_BAUD_RESET * OW_BAUD_DATA));
+}
+
 /**
  * \brief           Search devices on 1-wire network by using callback function and custom search command
  *
@@ -628,7 +1413,8 @@ ow_crc(const void* in, const size_t len) {
  * \param[in]       func: Callback function to call for each device
  * \param[in]       arg: Custom user argument, used in callback function
  * \return          \ref owOK on success, member of \ref owr_t otherwise
- * \note            This function is thread-safe
+ * \note            This function is thread-safe. Bus is locked for complete search, including callbacks.
+ *                  Use \ref ow_search_with_command_callback_yield to release it between devices
  */
 owr_t
 ow_search_with_command_callback(ow_t* const ow, const uint8_t cmd, size_t* const roms_found,
@@ -764,6 +1550,164 @@ ow_search_devices(ow_t* const ow, ow_rom_t* const rom_id_arr, const size_t rom_l
     return res;
 }
 
+#if OW_CFG_OS || __DOXYGEN__
+
+/**
+ * \brief           Acquire the bus, search single device and release the bus again
+ *
+ * Search state is restored to 1-Wire handle before search and saved back after it,
+ * other searches in the meantime do not affect it
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       cmd: 1-Wire search command
+ * \param[in,out]   state: Search state, ROM address and disrepancy of previous device
+ * \param[out]      rom_id: Output variable to save found device address
+ * \param[in,out]   stats: Bus hold and wait times to update
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_search_slice(ow_t* const ow, const uint8_t cmd, ow_search_state_t* const state,
+                 ow_rom_t* const rom_id, ow_search_stats_t* const stats) {
+    uint32_t start, t;
+    owr_t res;
+
+    start = ow_sys_get_tick(ow->arg);
+#if OW_CFG_ARBITER
+    if ((res = ow_protect_ex(ow, OW_PRIO_LOW, 0)) != owOK) {
+        return res;
+    }
+#else
+    ow_protect(ow, 1);
+#endif /* OW_CFG_ARBITER */
+    t = ow_sys_get_tick(ow->arg);
+    stats->wait_total += t - start;
+    if (t - start > stats->wait_max) {
+        stats->wait_max = t - start;
+    }
+
+    ow->rom = state->rom;
+    ow->disrepancy = state->disrepancy;
+    res = ow_search_with_command_raw(ow, cmd, rom_id);
+    state->rom = ow->rom;
+    state->disrepancy = ow->disrepancy;
+
+    start = t;
+    t = ow_sys_get_tick(ow->arg);
+#if OW_CFG_ARBITER
+    ow_unprotect_ex(ow);
+#else
+    ow_unprotect(ow, 1);
+#endif /* OW_CFG_ARBITER */
+    if (t - start > stats->hold_max) {
+        stats->hold_max = t - start;
+    }
+    ++stats->slices;
+    return res;
+}
+
+/**
+ * \brief           Search devices with custom search command, releasing the bus after each device
+ *
+ * Bus is locked only while single device is searched and released before callback is called.
+ * Other threads may access the bus between devices. Search state is kept locally
+ * and restored each time bus is acquired again.
+ *
+ * Every device search starts with reset pulse anyway, resuming adds no bus traffic.
+ * Bus is held for one search pass at a time: reset, search command and `192` time slots,
+ * `~18 ms` at default baudrate. Hold and wait times are measured and saved to `stats`.
+ *
+ * When \ref OW_CFG_ARBITER is enabled, bus is acquired with \ref OW_PRIO_LOW priority.
+ *
+ * \note            Calling thread must not hold the bus. Callback is called with bus released,
+ *                  it shall use thread-safe functions only
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       cmd: 1-Wire search command
+ * \param[out]      roms_found: Output variable to save number of found devices. Set to `NULL` if not used
+ * \param[in]       func: Callback function to call for each device
+ * \param[in]       arg: Custom user argument, used in callback function
+ * \param[out]      stats: Output variable to save bus hold and wait times. Set to `NULL` if not used
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_search_with_command_callback_yield(ow_t* const ow, const uint8_t cmd, size_t* const roms_found,
+                                      const ow_search_cb_fn func, void* arg, ow_search_stats_t* const stats) {
+    ow_search_state_t state = { .disrepancy = OW_FIRST_DEV };
+    ow_search_stats_t st = {0};
+    ow_rom_t rom_id;
+    owr_t res;
+    size_t i;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("func != NULL", func != NULL);
+
+    /* Search device-by-device until all found */
+    for (i = 0; (res = prv_search_slice(ow, cmd, &state, &rom_id, &st)) == owOK; ++i) {
+        if ((res = func(ow, &rom_id, i, arg)) != owOK) {
+            break;
+        }
+    }
+    func(ow, NULL, i, arg);                     /* Call with NULL rom_id parameter */
+
+    if (roms_found != NULL) {
+        *roms_found = i;
+    }
+    if (stats != NULL) {
+        *stats = st;
+    }
+    if (res == owERRNODEV) {                    /* `No device` might not be an error, but simply no devices on bus */
+        res = owOK;
+    }
+    return res;
+}
+
+/**
+ * \brief           Search for devices with command and store ROM IDs to input array, releasing the bus after each device
+ *
+ * Function works as \ref ow_search_devices_with_command, with bus locking
+ * of \ref ow_search_with_command_callback_yield
+ *
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       cmd: 1-Wire search command
+ * \param[in]       rom_id_arr: Pointer to output array to store found ROM IDs into
+ * \param[in]       rom_len: Length of input ROM array
+ * \param[out]      roms_found: Output variable to save number of found devices. Set to `NULL` if not used
+ * \param[out]      stats: Output variable to save bus hold and wait times. Set to `NULL` if not used
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function is thread-safe
+ */
+owr_t
+ow_search_devices_with_command_yield(ow_t* const ow, const uint8_t cmd, ow_rom_t* const rom_id_arr,
+                                     const size_t rom_len, size_t* const roms_found, ow_search_stats_t* const stats) {
+    ow_search_state_t state = { .disrepancy = OW_FIRST_DEV };
+    ow_search_stats_t st = {0};
+    owr_t res = owOK;
+    size_t cnt;
+
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("rom_id_arr != NULL", rom_id_arr != NULL);
+    OW_ASSERT("rom_len > 0", rom_len > 0);
+
+    for (cnt = 0; cnt < rom_len; ++cnt) {
+        if ((res = prv_search_slice(ow, cmd, &state, &rom_id_arr[cnt], &st)) != owOK) {
+            break;
+        }
+    }
+    if (roms_found != NULL) {
+        *roms_found = cnt;
+    }
+    if (stats != NULL) {
+        *stats = st;
+    }
+    if (res == owERRNODEV && cnt > 0) {
+        res = owOK;
+    }
+    return res;
+}
+
+#endif /* OW_CFG_OS || __DOXYGEN__ */
+
 /* Deprecated functions list */
 
 /**
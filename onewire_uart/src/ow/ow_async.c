@@ -0,0 +1,317 @@
+/**
+ * \file            ow_async.c
+ * \brief           Non-blocking transaction implementation
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#include <string.h>
+#include "ow/ow_async.h"
+
+#if OW_CFG_ASYNC || __DOXYGEN__
+
+#define OW_RESET_BYTE                   0xF0
+
+/**
+ * \brief           Complete transaction and call completion function
+ * \param[in]       async: Transaction handle
+ * \param[in]       res: Transaction result
+ */
+static void
+prv_complete(ow_async_t* const async, const owr_t res) {
+    ow_t* ow = async->ow;
+
+    /* Transaction may be stopped in the middle of reset pulse */
+    if (res != owOK && async->ops[async->op].type == OW_ASYNC_RESET) {
+        ow->ll_drv->set_baudrate(OW_BAUD_DATA, ow->arg);
+    }
+    async->busy = 0;
+    if (async->done != NULL) {
+        async->done(async, res, async->arg);
+    }
+}
+
+/**
+ * \brief           Encode and start transmission of next chunk of current operation
+ * \param[in]       async: Transaction handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_start_chunk(ow_async_t* const async) {
+    const ow_async_op_t* op = &async->ops[async->op];
+    ow_t* ow = async->ow;
+
+    async->received = 0;
+    if (op->type == OW_ASYNC_RESET) {
+        if (!ow->ll_drv->set_baudrate(OW_BAUD_RESET, ow->arg)) {
+            return owERRBAUD;
+        }
+        async->buff[0] = OW_RESET_BYTE;
+        async->chunk = 1;
+        async->expected = 1;
+    } else {
+        async->chunk = op->len - async->off;
+        if (async->chunk > OW_CFG_BATCH_BYTES) {
+            async->chunk = OW_CFG_BATCH_BYTES;
+        }
+
+        /* 8 UART bytes for each byte, LSB first. Reading is writing all ones */
+        for (size_t i = 0; i < async->chunk; ++i) {
+            for (uint8_t j = 0; j < 8; ++j) {
+                async->buff[8 * i + j] = op->type == OW_ASYNC_READ
+                                         || (op->tx[async->off + i] & (1 << j)) ? 0xFF : 0x00;
+            }
+        }
+        async->expected = 8 * async->chunk;
+    }
+    if (!ow->ll_drv->tx_start(async->buff, async->expected, ow->arg)) {
+        return owERRTXRX;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Process completely received chunk of current operation
+ * \param[in]       async: Transaction handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_finish_chunk(ow_async_t* const async) {
+    const ow_async_op_t* op = &async->ops[async->op];
+    ow_t* ow = async->ow;
+
+    if (op->type == OW_ASYNC_RESET) {
+        if (!ow->ll_drv->set_baudrate(OW_BAUD_DATA, ow->arg)) {
+            return owERRBAUD;
+        }
+        if (async->buff[0] == 0 || async->buff[0] == OW_RESET_BYTE) {
+            return owERRPRESENCE;
+        }
+        ++async->op;
+        return owOK;
+    }
+    if (op->rx != NULL) {
+        for (size_t i = 0; i < async->chunk; ++i) {
+            uint8_t r = 0;
+            for (uint8_t j = 0; j < 8; ++j) {
+                if (async->buff[8 * i + j] == 0xFF) {
+                    r |= 0x01 << j;
+                }
+            }
+            op->rx[async->off + i] = r;
+        }
+    }
+    async->off += async->chunk;
+    if (async->off >= op->len) {
+        async->off = 0;
+        ++async->op;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Start next chunk or complete transaction when all operations are done
+ * \param[in]       async: Transaction handle
+ */
+static void
+prv_next(ow_async_t* const async) {
+    owr_t res;
+
+    while (async->op < async->op_count
+           && async->ops[async->op].type != OW_ASYNC_RESET && async->ops[async->op].len == 0) {
+        ++async->op;                            /* Nothing to transfer */
+    }
+    if (async->op == async->op_count) {
+        --async->op;                            /* Keep valid index for completion */
+        prv_complete(async, owOK);
+    } else if ((res = prv_start_chunk(async)) != owOK) {
+        prv_complete(async, res);
+    }
+}
+
+/**
+ * \brief           Initialize transaction handle of the bus
+ * \param[out]      async: Transaction handle to initialize
+ * \param[in]       ow: 1-Wire handle, its low-level driver must implement `tx_start` and `rx_read` functions
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_async_init(ow_async_t* const async, ow_t* const ow) {
+    OW_ASSERT("async != NULL", async != NULL);
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    if (ow->ll_drv->tx_start == NULL || ow->ll_drv->rx_read == NULL) {
+        return owERR;
+    }
+    memset(async, 0x00, sizeof(*async));
+    async->ow = ow;
+    return owOK;
+}
+
+/**
+ * \brief           Start transaction on the bus
+ *
+ * Function starts transmission of first chunk and returns immediately.
+ * Completion function is called from \ref ow_async_process, \ref ow_async_check_timeout
+ * or \ref ow_async_abort, or from this function when transaction fails to start.
+ *
+ * \code{c}
+static const uint8_t convert[] = { OW_CMD_SKIPROM, 0x44 };
+static const ow_async_op_t ops[] = {
+    { .type = OW_ASYNC_RESET },
+    { .type = OW_ASYNC_WRITE, .tx = convert, .len = sizeof(convert) },
+};
+
+ow_async_start(&async, ops, OW_ARRAYSIZE(ops), convert_done, NULL, now);
+\endcode
+ *
+ * \param[in,out]   async: Transaction handle
+ * \param[in]       ops: Array of operations. Array and its buffers must stay valid until completion
+ * \param[in]       op_count: Number of operations in `ops` array
+ * \param[in]       done: Completion function. Set to `NULL` if not used
+ * \param[in]       arg: User argument for completion function
+ * \param[in]       now: Current time in units of milliseconds, used for timeout detection
+ * \return          \ref owOK when transaction is started or already completed, \ref owERR when bus is busy
+ */
+owr_t
+ow_async_start(ow_async_t* const async, const ow_async_op_t* const ops, const size_t op_count,
+               const ow_async_done_fn done, void* const arg, const uint32_t now) {
+    OW_ASSERT("async != NULL", async != NULL);
+    OW_ASSERT("ops != NULL", ops != NULL);
+    OW_ASSERT("op_count > 0", op_count > 0);
+
+    if (async->busy) {
+        return owERR;
+    }
+    async->ops = ops;
+    async->op_count = op_count;
+    async->op = 0;
+    async->off = 0;
+    async->done = done;
+    async->arg = arg;
+    async->time = now;
+    async->busy = 1;
+    prv_next(async);
+    return owOK;
+}
+
+/**
+ * \brief           Read received UART bytes and advance transaction
+ *
+ * Function never waits. It shall be called when UART of the bus has received data,
+ * all available data are processed. Received bytes are discarded when bus is idle.
+ *
+ * \param[in,out]   async: Transaction handle
+ * \param[in]       now: Current time in units of milliseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise.
+ *                      Result of transaction is passed to its completion function
+ */
+owr_t
+ow_async_process(ow_async_t* const async, const uint32_t now) {
+    ow_t* ow;
+    size_t n;
+    owr_t res;
+
+    OW_ASSERT("async != NULL", async != NULL);
+
+    ow = async->ow;
+    while (1) {
+        if (!async->busy) {
+            while (ow->ll_drv->rx_read(async->buff, sizeof(async->buff), ow->arg) > 0) {}
+            break;
+        }
+        if ((n = ow->ll_drv->rx_read(&async->buff[async->received],
+                                     async->expected - async->received, ow->arg)) == 0) {
+            break;
+        }
+        async->received += n;
+        async->time = now;
+        if (async->received == async->expected) {
+            if ((res = prv_finish_chunk(async)) != owOK) {
+                prv_complete(async, res);
+            } else {
+                prv_next(async);
+            }
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Abort transaction when no data were received for too long
+ * \param[in,out]   async: Transaction handle
+ * \param[in]       now: Current time in units of milliseconds
+ * \param[in]       timeout: Maximal time without received data in units of milliseconds
+ * \return          \ref owERRTIMEOUT when transaction was aborted, \ref owOK otherwise
+ */
+owr_t
+ow_async_check_timeout(ow_async_t* const async, const uint32_t now, const uint32_t timeout) {
+    OW_ASSERT("async != NULL", async != NULL);
+
+    /* Transaction may be started after `now` was read, its time is then in the future */
+    if (async->busy && (int32_t)(now - async->time) > (int32_t)timeout) {
+        prv_complete(async, owERRTIMEOUT);
+        return owERRTIMEOUT;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Abort transaction in progress
+ *
+ * Completion function is called with `res` result. Data of aborted chunk,
+ * received later, are discarded when next transaction starts
+ *
+ * \param[in,out]   async: Transaction handle
+ * \param[in]       res: Result passed to completion function
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_async_abort(ow_async_t* const async, const owr_t res) {
+    OW_ASSERT("async != NULL", async != NULL);
+
+    if (async->busy) {
+        prv_complete(async, res);
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Check if transaction is in progress
+ * \param[in]       async: Transaction handle
+ * \return          `1` when busy, `0` otherwise
+ */
+uint8_t
+ow_async_is_busy(const ow_async_t* const async) {
+    OW_ASSERT0("async != NULL", async != NULL);
+
+    return async->busy;
+}
+
+#endif /* OW_CFG_ASYNC || __DOXYGEN__ */
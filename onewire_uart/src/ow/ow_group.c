@@ -0,0 +1,424 @@
+/**
+ * \file            ow_group.c
+ * \brief           Multi-bus group implementation
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#include <string.h>
+#include "ow/ow_group.h"
+#include "ow/devices/ow_device_ds18x20.h"
+
+#if OW_CFG_GROUP || __DOXYGEN__
+
+#if !OW_CFG_OS
+#error "OW_CFG_OS must be enabled to use group"
+#endif /* !OW_CFG_OS */
+
+/* Pack and unpack pending range of worker */
+#define RANGE(lo, hi)               ((uint32_t)(lo) | ((uint32_t)(hi) << 16))
+#define RANGE_LO(r)                 ((uint32_t)(r) & 0xFFFF)
+#define RANGE_HI(r)                 ((uint32_t)(r) >> 16)
+
+/**
+ * \brief           Take next job of the worker, or steal one from other worker
+ *
+ * Worker takes jobs from the front of its own range.
+ * When range is empty, job is stolen from the back of the range with most pending jobs.
+ *
+ * \param[in]       group: Group handle
+ * \param[in]       index: Worker index
+ * \return          Bus index, `-1` when there are no pending jobs left
+ */
+static int32_t
+prv_take(ow_group_t* const group, const size_t index) {
+    uint32_t r, best, best_r;
+    size_t victim;
+
+    /* Own jobs first */
+    r = atomic_load_explicit(&group->ranges[index], memory_order_acquire);
+    while (RANGE_LO(r) < RANGE_HI(r)) {
+        if (atomic_compare_exchange_weak_explicit(&group->ranges[index], &r, RANGE(RANGE_LO(r) + 1, RANGE_HI(r)),
+                                                  memory_order_acq_rel, memory_order_acquire)) {
+            return group->queue[RANGE_LO(r)];
+        }
+    }
+
+    /* Steal from worker with most pending jobs, jobs are not added during operation */
+    for (;;) {
+        best = 0;
+        best_r = 0;
+        victim = index;
+        for (size_t i = 0; i < group->worker_count; ++i) {
+            r = atomic_load_explicit(&group->ranges[i], memory_order_acquire);
+            if (RANGE_HI(r) > RANGE_LO(r) && RANGE_HI(r) - RANGE_LO(r) > best) {
+                best = RANGE_HI(r) - RANGE_LO(r);
+                best_r = r;
+                victim = i;
+            }
+        }
+        if (best == 0) {
+            return -1;
+        }
+        if (atomic_compare_exchange_strong_explicit(&group->ranges[victim], &best_r, RANGE(RANGE_LO(best_r), RANGE_HI(best_r) - 1),
+                                                    memory_order_acq_rel, memory_order_acquire)) {
+            ++group->steals[index];
+            return group->queue[RANGE_HI(best_r) - 1];
+        }
+    }
+}
+
+/**
+ * \brief           Scan job, find all devices of the bus
+ * \param[in]       group: Group handle
+ * \param[in]       bus: Bus to scan
+ * \param[in]       arg: Unused
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_scan(ow_group_t* const group, ow_group_bus_t* const bus, void* arg) {
+    owr_t res;
+
+    OW_UNUSED(arg);
+    bus->rom_count = 0;
+    res = ow_search_devices_raw(bus->ow, bus->rom_ids, bus->rom_len, &bus->rom_count);
+    if (res == owERRNODEV || res == owERRPRESENCE) { /* Empty bus is not an error */
+        bus->rom_count = 0;
+        res = owOK;
+    }
+    if (res != owOK) {
+        return res;
+    }
+    for (size_t i = 0; i < bus->rom_count; ++i) {
+        ow_group_add_result(group, bus, &bus->rom_ids[i], owOK, 0);
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Poll job, convert and read temperature of all `DS18x20` devices of the bus
+ * \param[in]       group: Group handle
+ * \param[in]       bus: Bus to poll
+ * \param[in]       arg: Unused
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_poll(ow_group_t* const group, ow_group_bus_t* const bus, void* arg) {
+    ow_ds18x20_result_t r = {0};
+    owr_t res;
+
+    OW_UNUSED(arg);
+    if (bus->rom_count == 0) {
+        return owOK;
+    }
+    if ((res = ow_ds18x20_convert_raw(bus->ow, bus->rom_ids, bus->rom_count)) != owOK) {
+        return res;
+    }
+    for (size_t i = 0; i < bus->rom_count; ++i) {
+        if (ow_ds18x20_is_b(bus->ow, &bus->rom_ids[i]) || ow_ds18x20_is_s(bus->ow, &bus->rom_ids[i])) {
+            res = ow_ds18x20_read_ex_raw(bus->ow, &bus->rom_ids[i], &r);
+            ow_group_add_result(group, bus, &bus->rom_ids[i], res, res == owOK ? r.raw : 0);
+            if (res == owERRCANCEL || res == owERRTIMEOUT) {
+                return res;                     /* Stop polling the bus, remaining devices fail the same way */
+            }
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Initialize group
+ * \param[out]      group: Group handle to initialize
+ * \param[in]       buses: Array of buses, each with initialized 1-Wire handle and ROM array
+ * \param[in]       bus_count: Number of buses, up to \ref OW_CFG_GROUP_BUSES
+ * \param[in]       worker_count: Number of worker threads, up to \ref OW_CFG_GROUP_WORKERS
+ * \param[in]       results: Array to save merged results to
+ * \param[in]       result_len: Number of entries in `results` array
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_group_init(ow_group_t* const group, ow_group_bus_t* const buses, const size_t bus_count,
+              const size_t worker_count, ow_group_result_t* const results, const size_t result_len) {
+    void* arg;
+
+    OW_ASSERT("group != NULL", group != NULL);
+    OW_ASSERT("buses != NULL", buses != NULL);
+    OW_ASSERT("bus_count > 0 && bus_count <= OW_CFG_GROUP_BUSES", bus_count > 0 && bus_count <= OW_CFG_GROUP_BUSES);
+    OW_ASSERT("worker_count > 0 && worker_count <= OW_CFG_GROUP_WORKERS", worker_count > 0 && worker_count <= OW_CFG_GROUP_WORKERS);
+    OW_ASSERT("results != NULL || result_len == 0", results != NULL || result_len == 0);
+
+    memset(group, 0x00, sizeof(*group));
+    group->buses = buses;
+    group->bus_count = bus_count;
+    group->worker_count = worker_count;
+    group->results = results;
+    group->result_len = result_len;
+    atomic_init(&group->result_count, 0);
+    atomic_init(&group->active, 0);
+    for (size_t i = 0; i < OW_CFG_GROUP_WORKERS; ++i) {
+        atomic_init(&group->ranges[i], 0);
+    }
+
+    arg = buses[0].ow->arg;
+    if (!ow_sys_sem_create(&group->done, arg)) {
+        return owERR;
+    }
+    for (size_t i = 0; i < worker_count; ++i) {
+        if (!ow_sys_sem_create(&group->start[i], arg)) {
+            while (i-- > 0) {
+                ow_sys_sem_delete(&group->start[i], arg);
+            }
+            ow_sys_sem_delete(&group->done, arg);
+            return owERR;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           De-initialize group
+ * \note            Worker threads must be stopped with \ref ow_group_stop before
+ * \param[in]       group: Group handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_group_deinit(ow_group_t* const group) {
+    void* arg;
+
+    OW_ASSERT("group != NULL", group != NULL);
+
+    arg = group->buses[0].ow->arg;
+    for (size_t i = 0; i < group->worker_count; ++i) {
+        ow_sys_sem_delete(&group->start[i], arg);
+    }
+    ow_sys_sem_delete(&group->done, arg);
+    return owOK;
+}
+
+/**
+ * \brief           Execute jobs of group operations until group is stopped
+ *
+ * Function is body of worker thread, one thread for each worker index.
+ * Thread sleeps until operation is started with \ref ow_group_run.
+ * Each job is executed with its bus locked.
+ *
+ * \param[in]       group: Group handle
+ * \param[in]       index: Worker index, from `0` to `worker_count - 1`
+ * \return          \ref owOK when stopped with \ref ow_group_stop, member of \ref owr_t otherwise
+ */
+owr_t
+ow_group_worker(ow_group_t* const group, const size_t index) {
+    ow_group_bus_t* bus;
+    int32_t b;
+    uint32_t start;
+    void* arg;
+
+    OW_ASSERT("group != NULL", group != NULL);
+    OW_ASSERT("index < group->worker_count", index < group->worker_count);
+
+    arg = group->buses[0].ow->arg;
+    for (;;) {
+        if (!ow_sys_sem_wait(&group->start[index], 0, arg)) {
+            return owERR;
+        }
+        if (group->stop) {
+            break;
+        }
+        while ((b = prv_take(group, index)) >= 0) {
+            bus = &group->buses[b];
+            start = ow_sys_get_tick(bus->ow->arg);
+            ow_protect(bus->ow, 1);
+            bus->status = group->fn(group, bus, group->arg);
+            ow_unprotect(bus->ow, 1);
+            bus->time = ow_sys_get_tick(bus->ow->arg) - start;
+            bus->worker = (uint16_t)index;
+        }
+        if (atomic_fetch_sub_explicit(&group->active, 1, memory_order_acq_rel) == 1) {
+            ow_sys_sem_release(&group->done, arg);
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Stop worker threads
+ * \param[in]       group: Group handle, with no operation in progress
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_group_stop(ow_group_t* const group) {
+    OW_ASSERT("group != NULL", group != NULL);
+
+    group->stop = 1;
+    for (size_t i = 0; i < group->worker_count; ++i) {
+        ow_sys_sem_release(&group->start[i], group->buses[0].ow->arg);
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Run job function on all buses and wait for completion
+ *
+ * Buses are ordered by number of devices found on last scan, largest first,
+ * and dealt to workers in turns. Workers steal remaining jobs when they run out of own.
+ * Merged results are available in `results` array when function returns.
+ *
+ * \param[in]       group: Group handle
+ * \param[in]       fn: Job function, executed once for each bus
+ * \param[in]       arg: User argument for job function
+ * \return          \ref owOK when job succeeded on all buses, result of first failed bus otherwise
+ * \note            This function shall be called from single thread only, not from worker thread
+ */
+owr_t
+ow_group_run(ow_group_t* const group, const ow_group_job_fn fn, void* const arg) {
+    uint16_t order[OW_CFG_GROUP_BUSES], tmp;
+    size_t pos = 0, workers;
+
+    OW_ASSERT("group != NULL", group != NULL);
+    OW_ASSERT("fn != NULL", fn != NULL);
+
+    /* Largest buses first, they are started early and small ones fill the gaps */
+    for (size_t i = 0; i < group->bus_count; ++i) {
+        order[i] = (uint16_t)i;
+        for (size_t j = i; j > 0 && group->buses[order[j]].rom_count > group->buses[order[j - 1]].rom_count; --j) {
+            tmp = order[j];
+            order[j] = order[j - 1];
+            order[j - 1] = tmp;
+        }
+    }
+
+    /* Worker `w` gets buses `w`, `w + workers`, ... of the order, as contiguous range */
+    workers = group->worker_count;
+    for (size_t w = 0; w < workers; ++w) {
+        size_t lo = pos;
+
+        for (size_t i = w; i < group->bus_count; i += workers) {
+            group->queue[pos++] = order[i];
+        }
+        atomic_store_explicit(&group->ranges[w], RANGE(lo, pos), memory_order_relaxed);
+    }
+
+    group->fn = fn;
+    group->arg = arg;
+    memset(group->steals, 0x00, sizeof(group->steals));
+    atomic_store_explicit(&group->result_count, 0, memory_order_relaxed);
+    atomic_store_explicit(&group->active, (uint32_t)workers, memory_order_release);
+    for (size_t w = 0; w < workers; ++w) {
+        ow_sys_sem_release(&group->start[w], group->buses[0].ow->arg);
+    }
+    if (!ow_sys_sem_wait(&group->done, 0, group->buses[0].ow->arg)) {
+        return owERR;
+    }
+
+    for (size_t i = 0; i < group->bus_count; ++i) {
+        if (group->buses[i].status != owOK) {
+            return group->buses[i].status;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Find all devices on all buses
+ *
+ * ROM array of each bus is filled and all devices are added to merged results
+ *
+ * \param[in]       group: Group handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_group_scan(ow_group_t* const group) {
+    return ow_group_run(group, prv_scan, NULL);
+}
+
+/**
+ * \brief           Convert and read temperature of all `DS18x20` devices on all buses
+ *
+ * Devices found by last \ref ow_group_scan are used.
+ * Conversion is started once for all devices of each bus
+ *
+ * \param[in]       group: Group handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_group_poll(ow_group_t* const group) {
+    return ow_group_run(group, prv_poll, NULL);
+}
+
+/**
+ * \brief           Add entry to merged results
+ *
+ * Function may be called by job functions of all workers at the same time.
+ * Entry is dropped when `results` array is full
+ *
+ * \param[in]       group: Group handle
+ * \param[in]       bus: Bus of the device
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[in]       status: Device status
+ * \param[in]       value: Raw device value
+ * \return          \ref owOK on success, \ref owERR when results array is full
+ */
+owr_t
+ow_group_add_result(ow_group_t* const group, const ow_group_bus_t* const bus, const ow_rom_t* const rom_id,
+                    const owr_t status, const int32_t value) {
+    ow_group_result_t* r;
+    size_t pos;
+
+    OW_ASSERT("group != NULL", group != NULL);
+    OW_ASSERT("bus != NULL", bus != NULL);
+    OW_ASSERT("rom_id != NULL", rom_id != NULL);
+
+    pos = atomic_fetch_add_explicit(&group->result_count, 1, memory_order_relaxed);
+    if (pos >= group->result_len) {
+        return owERR;
+    }
+    r = &group->results[pos];
+    r->bus = (uint16_t)(bus - group->buses);
+    r->rom = *rom_id;
+    r->status = status;
+    r->value = value;
+    return owOK;
+}
+
+/**
+ * \brief           Get number of valid entries in merged results of last operation
+ * \param[in]       group: Group handle
+ * \return          Number of entries, up to `result_len`
+ */
+size_t
+ow_group_get_result_count(ow_group_t* const group) {
+    size_t count;
+
+    OW_ASSERT0("group != NULL", group != NULL);
+
+    count = atomic_load_explicit(&group->result_count, memory_order_acquire);
+    return count < group->result_len ? count : group->result_len;
+}
+
+#endif /* OW_CFG_GROUP || __DOXYGEN__ */
@@ -0,0 +1,334 @@
+/**
+ * \file            ow_sampler.c
+ * \brief           Periodic sampler implementation
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#include <string.h>
+#include "ow/ow_sampler.h"
+#include "ow/devices/ow_device_ds18x20.h"
+
+#if OW_CFG_SAMPLER || __DOXYGEN__
+
+#if !OW_CFG_OS
+#error "OW_CFG_OS must be enabled to use sampler"
+#endif /* !OW_CFG_OS */
+
+/**
+ * \brief           Default cycle start function, start conversion on all `DS18x20` devices
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       arg: Sampler handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_ds18x20_start(ow_t* const ow, void* arg) {
+    ow_sampler_t* sampler = arg;
+
+    return ow_ds18x20_convert_raw(ow, sampler->rom_ids, sampler->rom_len);
+}
+
+/**
+ * \brief           Default device read function, read temperature of `DS18x20` device
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_id: 1-Wire device address
+ * \param[out]      value: Output variable to save temperature in units of `1/16` degree Celsius
+ * \param[in]       arg: Sampler handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_ds18x20_read(ow_t* const ow, const ow_rom_t* const rom_id, int32_t* const value, void* arg) {
+    ow_ds18x20_result_t r;
+    owr_t res;
+
+    OW_UNUSED(arg);
+    if ((res = ow_ds18x20_read_ex_raw(ow, rom_id, &r)) == owOK) {
+        *value = r.raw;
+    }
+    return res;
+}
+
+/**
+ * \brief           Write sample to ring buffer
+ *
+ * Slot sequence number is odd while sample is written,
+ * readers detect concurrent writes by comparing sequence before and after copy.
+ *
+ * \param[in]       sampler: Sampler handle
+ * \param[in]       sample: Sample to write
+ */
+static void
+prv_push(ow_sampler_t* const sampler, const ow_sample_t* const sample) {
+    uint32_t pos = (uint32_t)atomic_load_explicit(&sampler->head, memory_order_relaxed);
+    ow_sampler_slot_t* slot = &sampler->slots[pos & sampler->mask];
+
+    atomic_store_explicit(&slot->seq, 2U * pos + 1U, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    slot->sample = *sample;
+    atomic_store_explicit(&slot->seq, 2U * pos + 2U, memory_order_release);
+    atomic_store_explicit(&sampler->head, pos + 1U, memory_order_release);
+}
+
+/**
+ * \brief           Initialize sampler
+ *
+ * By default, sampler reads temperature of `DS18x20` devices.
+ * Use \ref ow_sampler_set_functions to sample other devices.
+ *
+ * \param[out]      sampler: Sampler handle to initialize
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       rom_ids: Array of devices to sample. Must be valid while sampler is used
+ * \param[in]       rom_len: Number of devices
+ * \param[in]       period: Sample period in units of milliseconds. Set to `0` to sample continuously
+ * \param[in]       slots: Array of ring buffer slots
+ * \param[in]       slot_count: Number of slots, must be power of `2`
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sampler_init(ow_sampler_t* const sampler, ow_t* const ow, const ow_rom_t* const rom_ids, const size_t rom_len,
+                const uint32_t period, ow_sampler_slot_t* const slots, const size_t slot_count) {
+    OW_ASSERT("sampler != NULL", sampler != NULL);
+    OW_ASSERT("ow != NULL", ow != NULL);
+    OW_ASSERT("rom_ids != NULL", rom_ids != NULL);
+    OW_ASSERT("rom_len > 0 && rom_len <= 0xFFFF", rom_len > 0 && rom_len <= 0xFFFF);
+    OW_ASSERT("slots != NULL", slots != NULL);
+    OW_ASSERT("slot_count is power of 2", slot_count > 0 && (slot_count & (slot_count - 1)) == 0);
+
+    memset(sampler, 0x00, sizeof(*sampler));
+    sampler->ow = ow;
+    sampler->rom_ids = rom_ids;
+    sampler->rom_len = rom_len;
+    sampler->period = period;
+    sampler->start_fn = prv_ds18x20_start;
+    sampler->read_fn = prv_ds18x20_read;
+    sampler->arg = sampler;
+    sampler->slots = slots;
+    sampler->mask = (uint32_t)slot_count - 1;
+    for (size_t i = 0; i < slot_count; ++i) {
+        atomic_init(&slots[i].seq, 0);
+    }
+    atomic_init(&sampler->head, 0);
+    sampler->next_tick = ow_sys_get_tick(ow->arg);
+    return owOK;
+}
+
+/**
+ * \brief           Set functions to sample generic devices
+ * \param[in]       sampler: Sampler handle
+ * \param[in]       start_fn: Function called once per cycle before devices are read. Set to `NULL` if not used
+ * \param[in]       read_fn: Function to read single device
+ * \param[in]       arg: User argument passed to both functions
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sampler_set_functions(ow_sampler_t* const sampler, const ow_sampler_start_fn start_fn,
+                         const ow_sampler_read_fn read_fn, void* const arg) {
+    OW_ASSERT("sampler != NULL", sampler != NULL);
+    OW_ASSERT("read_fn != NULL", read_fn != NULL);
+
+    sampler->start_fn = start_fn;
+    sampler->read_fn = read_fn;
+    sampler->arg = arg;
+    return owOK;
+}
+
+/**
+ * \brief           Run sampling cycle when it is due
+ *
+ * All devices are sampled in single cycle with bus locked,
+ * and samples are written to ring buffer.
+ *
+ * Start delay of each cycle is tracked as jitter. When cycle ends after next cycle was due,
+ * missed periods are counted as overruns and schedule restarts from current time.
+ *
+ * \param[in]       sampler: Sampler handle
+ * \param[out]      next_ms: Output variable to save time in milliseconds until next cycle is due.
+ *                      Set to `NULL` if not used
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ * \note            This function shall be called from single thread only
+ */
+owr_t
+ow_sampler_step(ow_sampler_t* const sampler, uint32_t* const next_ms) {
+    ow_sample_t sample;
+    uint32_t now, late;
+    owr_t res = owOK;
+
+    OW_ASSERT("sampler != NULL", sampler != NULL);
+
+    now = ow_sys_get_tick(sampler->ow->arg);
+    if ((int32_t)(sampler->next_tick - now) > 0) {
+        if (next_ms != NULL) {
+            *next_ms = sampler->next_tick - now;
+        }
+        return owOK;
+    }
+
+    /* Track start delay */
+    late = now - sampler->next_tick;
+    sampler->jitter_last = late;
+    if (late > sampler->jitter_max) {
+        sampler->jitter_max = late;
+    }
+
+    /* Acquire samples of all devices */
+    ow_protect(sampler->ow, 1);
+    if (sampler->start_fn != NULL) {
+        res = sampler->start_fn(sampler->ow, sampler->arg);
+    }
+    sample.tick = ow_sys_get_tick(sampler->ow->arg);
+    for (size_t i = 0; i < sampler->rom_len; ++i) {
+        sample.index = (uint16_t)i;
+        sample.value = 0;
+        if (res == owOK) {
+            if (sampler->start_fn == NULL) {
+                sample.tick = ow_sys_get_tick(sampler->ow->arg);
+            }
+            sample.status = sampler->read_fn(sampler->ow, &sampler->rom_ids[i], &sample.value, sampler->arg);
+        } else {
+            sample.status = res;                /* Cycle start failed for all devices */
+        }
+        prv_push(sampler, &sample);
+    }
+    ow_unprotect(sampler->ow, 1);
+    ++sampler->cycles;
+
+    /* Schedule next cycle */
+    sampler->next_tick += sampler->period;
+    now = ow_sys_get_tick(sampler->ow->arg);
+    if (sampler->period == 0) {
+        sampler->next_tick = now;               /* Sample continuously */
+    } else if ((int32_t)(now - sampler->next_tick) >= (int32_t)sampler->period) {
+        sampler->overruns += (now - sampler->next_tick) / sampler->period;
+        sampler->next_tick = now;
+    }
+    if (next_ms != NULL) {
+        *next_ms = (int32_t)(sampler->next_tick - now) > 0 ? sampler->next_tick - now : 0;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Run sampler for specific time
+ *
+ * Thread sleeps with \ref ow_sys_delay between cycles, bus is released in the meantime
+ *
+ * \param[in]       sampler: Sampler handle
+ * \param[in]       duration: Time to run sampler in units of milliseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sampler_run(ow_sampler_t* const sampler, const uint32_t duration) {
+    uint32_t start, next_ms;
+    owr_t res;
+
+    OW_ASSERT("sampler != NULL", sampler != NULL);
+
+    start = ow_sys_get_tick(sampler->ow->arg);
+    do {
+        if ((res = ow_sampler_step(sampler, &next_ms)) != owOK) {
+            return res;
+        }
+        if (next_ms > 0) {
+            ow_sys_delay(next_ms, sampler->ow->arg);
+        }
+    } while ((ow_sys_get_tick(sampler->ow->arg) - start) < duration);
+    return owOK;
+}
+
+/**
+ * \brief           Initialize consumer of sampler
+ *
+ * Consumer receives samples written after initialization
+ *
+ * \param[out]      reader: Consumer handle to initialize
+ * \param[in]       sampler: Sampler handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sampler_reader_init(ow_sampler_reader_t* const reader, ow_sampler_t* const sampler) {
+    OW_ASSERT("reader != NULL", reader != NULL);
+    OW_ASSERT("sampler != NULL", sampler != NULL);
+
+    reader->sampler = sampler;
+    reader->tail = (uint32_t)atomic_load_explicit(&sampler->head, memory_order_acquire);
+    reader->lost = 0;
+    return owOK;
+}
+
+/**
+ * \brief           Read next sample
+ *
+ * Function never blocks and does not access the bus.
+ * When consumer is too slow and samples are overwritten,
+ * they are skipped and counted in `lost` member of consumer handle.
+ *
+ * \param[in]       reader: Consumer handle
+ * \param[out]      sample: Output variable to save sample
+ * \return          `1` when sample has been read, `0` when no new sample is available
+ * \note            This function is thread-safe for different consumer handles
+ */
+uint8_t
+ow_sampler_read(ow_sampler_reader_t* const reader, ow_sample_t* const sample) {
+    ow_sampler_t* sampler;
+    uint32_t head, seq;
+    const ow_sampler_slot_t* slot;
+
+    OW_ASSERT0("reader != NULL", reader != NULL);
+    OW_ASSERT0("sample != NULL", sample != NULL);
+
+    sampler = reader->sampler;
+    while (1) {
+        head = (uint32_t)atomic_load_explicit(&sampler->head, memory_order_acquire);
+        if (head == reader->tail) {
+            return 0;
+        }
+
+        /* Skip samples already overwritten */
+        if ((head - reader->tail) > sampler->mask + 1) {
+            reader->lost += (head - reader->tail) - (sampler->mask + 1);
+            reader->tail = head - (sampler->mask + 1);
+        }
+
+        /* Copy sample and check it was not overwritten meanwhile */
+        slot = &sampler->slots[reader->tail & sampler->mask];
+        seq = (uint32_t)atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq == 2U * reader->tail + 2U) {
+            *sample = slot->sample;
+            atomic_thread_fence(memory_order_acquire);
+            if ((uint32_t)atomic_load_explicit(&slot->seq, memory_order_relaxed) == seq) {
+                ++reader->tail;
+                return 1;
+            }
+        }
+        ++reader->lost;
+        ++reader->tail;
+    }
+}
+
+#endif /* OW_CFG_SAMPLER || __DOXYGEN__ */
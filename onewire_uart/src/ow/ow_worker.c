@@ -0,0 +1,357 @@
+/**
+ * \file            ow_worker.c
+ * \brief           Bus worker implementation
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#include <string.h>
+#include "ow/ow_worker.h"
+
+#if OW_CFG_WORKER || __DOXYGEN__
+
+#if !OW_CFG_OS
+#error "OW_CFG_OS must be enabled to use worker"
+#endif /* !OW_CFG_OS */
+
+/* Flag in pending counter, set when worker does not accept requests anymore */
+#define OW_WORKER_CLOSED                    ((uint_least32_t)1 << 31)
+
+/**
+ * \brief           Append request to the queue
+ *
+ * Producers are serialized by single atomic exchange of queue head.
+ * Request becomes visible to worker when previous head is linked to it.
+ *
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request to append
+ */
+static void
+prv_push(ow_worker_t* const worker, ow_work_t* const work) {
+    ow_work_t* prev;
+
+    atomic_store_explicit(&work->next, NULL, memory_order_relaxed);
+    prev = atomic_exchange_explicit(&worker->head, work, memory_order_acq_rel);
+    atomic_store_explicit(&prev->next, work, memory_order_release);
+}
+
+/**
+ * \brief           Remove oldest request from the queue
+ * \param[in]       worker: Worker handle
+ * \return          Request to execute, `NULL` when queue is empty
+ *                      or when producer has not linked its request yet
+ * \note            This function shall be called from worker thread only
+ */
+static ow_work_t*
+prv_pop(ow_worker_t* const worker) {
+    ow_work_t *tail = worker->tail, *next;
+
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (tail == &worker->stub) {                /* Skip placeholder */
+        if (next == NULL) {
+            return NULL;
+        }
+        worker->tail = next;
+        tail = next;
+        next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    }
+    if (next != NULL) {
+        worker->tail = next;
+        return tail;
+    }
+    if (tail != atomic_load_explicit(&worker->head, memory_order_acquire)) {
+        return NULL;                            /* Producer is in the middle of push */
+    }
+
+    /* Last request in queue, put placeholder behind it before it is returned */
+    prv_push(worker, &worker->stub);
+    next = atomic_load_explicit(&tail->next, memory_order_acquire);
+    if (next != NULL) {
+        worker->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Stop request function
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       arg: Worker handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+static owr_t
+prv_stop(ow_t* const ow, void* arg) {
+    ow_worker_t* worker = arg;
+
+    OW_UNUSED(ow);
+    worker->stop = 1;
+    return owOK;
+}
+
+/**
+ * \brief           Initialize worker
+ * \param[out]      worker: Worker handle to initialize
+ * \param[in]       ow: 1-Wire handle, owned by worker thread afterwards
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_worker_init(ow_worker_t* const worker, ow_t* const ow) {
+    OW_ASSERT("worker != NULL", worker != NULL);
+    OW_ASSERT("ow != NULL", ow != NULL);
+
+    memset(worker, 0x00, sizeof(*worker));
+    worker->ow = ow;
+    atomic_init(&worker->stub.next, NULL);
+    atomic_init(&worker->head, &worker->stub);
+    atomic_init(&worker->pending, 0);
+    worker->tail = &worker->stub;
+    if (!ow_sys_sem_create(&worker->sem, ow->arg)) {
+        return owERR;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           De-initialize worker
+ * \note            Worker thread must be stopped with \ref ow_worker_stop before
+ * \param[in]       worker: Worker handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_worker_deinit(ow_worker_t* const worker) {
+    OW_ASSERT("worker != NULL", worker != NULL);
+
+    ow_sys_sem_delete(&worker->sem, worker->ow->arg);
+    return owOK;
+}
+
+/**
+ * \brief           Execute submitted requests until worker is stopped
+ *
+ * Function is body of worker thread. Thread sleeps while queue is empty.
+ * When first request is submitted, bus is locked and requests are executed
+ * back to back, until queue is empty again. Requests do not wait for bus mutex
+ * and there is no mutex handoff between them.
+ *
+ * After stop request, requests still in queue are completed with \ref owERR result
+ * without execution, and new requests are rejected by \ref ow_worker_submit.
+ *
+ * \param[in]       worker: Worker handle
+ * \return          \ref owOK when stopped with \ref ow_worker_stop, member of \ref owr_t otherwise
+ * \note            This function shall be called from single thread only
+ */
+owr_t
+ow_worker_run(ow_worker_t* const worker) {
+    ow_work_t* work;
+    void* arg;
+
+    OW_ASSERT("worker != NULL", worker != NULL);
+
+    arg = worker->ow->arg;
+    while (!worker->stop) {
+        if (!ow_sys_sem_wait(&worker->sem, 0, arg)) {
+            return owERR;
+        }
+        ow_protect(worker->ow, 1);
+        ++worker->batches;
+        do {
+            while ((work = prv_pop(worker)) == NULL) {
+                ow_sys_delay(1, arg);           /* Producer was preempted while linking its request */
+            }
+            work->res = work->fn(worker->ow, work->arg);
+            ++worker->processed;
+            ow_sys_sem_release(&work->done, arg);
+        } while (!worker->stop
+                 && atomic_fetch_sub_explicit(&worker->pending, 1, memory_order_acq_rel) > 1);
+        ow_unprotect(worker->ow, 1);
+    }
+
+    /* Close the queue and complete remaining requests, including stop request itself */
+    atomic_fetch_or_explicit(&worker->pending, OW_WORKER_CLOSED, memory_order_acq_rel);
+    while ((atomic_fetch_sub_explicit(&worker->pending, 1, memory_order_acq_rel) & ~OW_WORKER_CLOSED) > 1) {
+        while ((work = prv_pop(worker)) == NULL) {
+            ow_sys_delay(1, arg);
+        }
+        work->res = owERR;
+        ow_sys_sem_release(&work->done, arg);
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Stop worker thread
+ *
+ * Stop request is queued as any other request, requests submitted before are executed.
+ * Requests submitted afterwards are not executed, they complete with \ref owERR result
+ * or are rejected on submission
+ *
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request handle of calling thread, initialized with \ref ow_work_init
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_worker_stop(ow_worker_t* const worker, ow_work_t* const work) {
+    return ow_worker_call(worker, work, prv_stop, worker);
+}
+
+/**
+ * \brief           Initialize request handle
+ *
+ * Request handle is owned by submitting thread and reused for all its requests
+ *
+ * \param[out]      work: Request handle to initialize
+ * \param[in]       arg: User argument passed on \ref ow_init function of the worker bus
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_work_init(ow_work_t* const work, void* const arg) {
+    OW_ASSERT("work != NULL", work != NULL);
+
+    memset(work, 0x00, sizeof(*work));
+    atomic_init(&work->next, NULL);
+    if (!ow_sys_sem_create(&work->done, arg)) {
+        return owERR;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           De-initialize request handle
+ * \param[in]       work: Request handle, not queued anymore
+ * \param[in]       arg: User argument passed on \ref ow_init function of the worker bus
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_work_deinit(ow_work_t* const work, void* const arg) {
+    OW_ASSERT("work != NULL", work != NULL);
+
+    ow_sys_sem_delete(&work->done, arg);
+    return owOK;
+}
+
+/**
+ * \brief           Submit request to worker without waiting for completion
+ *
+ * Function does not block and may be called from multiple threads at the same time.
+ * Worker thread is woken up only when queue was empty.
+ *
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request handle, not queued at the moment
+ * \param[in]       fn: Operation function, executed by worker thread with bus locked
+ * \param[in]       arg: User argument for function
+ * \return          \ref owOK on success, \ref owERR when worker has been stopped,
+ *                      member of \ref owr_t otherwise
+ */
+owr_t
+ow_worker_submit(ow_worker_t* const worker, ow_work_t* const work, const ow_work_fn fn, void* const arg) {
+    uint_least32_t cnt;
+
+    OW_ASSERT("worker != NULL", worker != NULL);
+    OW_ASSERT("work != NULL", work != NULL);
+    OW_ASSERT("fn != NULL", fn != NULL);
+
+    /* Count request first, stopped worker does not take it from the queue anymore */
+    cnt = atomic_load_explicit(&worker->pending, memory_order_acquire);
+    do {
+        if (cnt & OW_WORKER_CLOSED) {
+            return owERR;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&worker->pending, &cnt, cnt + 1,
+                                                    memory_order_acq_rel, memory_order_acquire));
+    work->fn = fn;
+    work->arg = arg;
+    work->res = owERR;
+    prv_push(worker, work);
+    if (cnt == 0) {
+        if (!ow_sys_sem_release(&worker->sem, worker->ow->arg)) {
+            return owERR;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Wait for submitted request to complete
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request handle, submitted with \ref ow_worker_submit
+ * \return          Result of operation function, member of \ref owr_t otherwise
+ */
+owr_t
+ow_worker_wait(ow_worker_t* const worker, ow_work_t* const work) {
+    OW_ASSERT("worker != NULL", worker != NULL);
+    OW_ASSERT("work != NULL", work != NULL);
+
+    if (!ow_sys_sem_wait(&work->done, 0, worker->ow->arg)) {
+        return owERR;
+    }
+    return work->res;
+}
+
+/**
+ * \brief           Submit request to worker and wait for its completion
+ *
+ * \code{c}
+typedef struct {
+    const ow_rom_t* rom_id;
+    ow_ds18x20_result_t result;
+} read_temp_t;
+
+static owr_t
+read_temp(ow_t* const ow, void* arg) {
+    read_temp_t* r = arg;
+    return ow_ds18x20_read_ex_raw(ow, r->rom_id, &r->result);
+}
+
+//In client thread
+read_temp_t r = { .rom_id = &rom_ids[0] };
+ow_work_t work;
+
+ow_work_init(&work, NULL);
+if (ow_worker_call(&worker, &work, read_temp, &r) == owOK) {
+    //Use r.result
+}
+\endcode
+ *
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request handle of calling thread
+ * \param[in]       fn: Operation function, executed by worker thread with bus locked
+ * \param[in]       arg: User argument for function
+ * \return          Result of operation function, member of \ref owr_t otherwise
+ */
+owr_t
+ow_worker_call(ow_worker_t* const worker, ow_work_t* const work, const ow_work_fn fn, void* const arg) {
+    owr_t res;
+
+    if ((res = ow_worker_submit(worker, work, fn, arg)) != owOK) {
+        return res;
+    }
+    return ow_worker_wait(worker, work);
+}
+
+#endif /* OW_CFG_WORKER || __DOXYGEN__ */
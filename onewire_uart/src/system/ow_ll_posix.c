@@ -0,0 +1,312 @@
+/**
+ * \file            ow_ll_posix.c
+ * \brief           UART driver for POSIX serial ports with Linux event loop
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef _DEFAULT_SOURCE
+#define _DEFAULT_SOURCE                         /* Raw terminal mode, flow control flags and monotonic clock */
+#endif
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include "system/ow_ll_posix.h"
+#if OW_CFG_ASYNC
+#include <sys/epoll.h>
+#endif /* OW_CFG_ASYNC */
+
+#if !__DOXYGEN__
+
+/* Function prototypes */
+static uint8_t init(void* arg);
+static uint8_t deinit(void* arg);
+static uint8_t set_baudrate(uint32_t baud, void* arg);
+static uint8_t transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg);
+static uint8_t transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg);
+static uint8_t transmit_start(const uint8_t* tx, size_t len, void* arg);
+static size_t receive_read(uint8_t* rx, size_t len, void* arg);
+
+/* POSIX LL driver for OW */
+const ow_ll_drv_t
+ow_ll_drv_posix = {
+    .init = init,
+    .deinit = deinit,
+    .set_baudrate = set_baudrate,
+    .tx_rx = transmit_receive,
+    .tx_rx_timeout = transmit_receive_timeout,
+    .tx_start = transmit_start,
+    .rx_read = receive_read,
+};
+
+static uint8_t
+init(void* arg) {
+    ow_ll_posix_t* port = arg;
+    struct termios tio;
+
+    /* Descriptor never blocks, blocking transfers wait with poll */
+    if ((port->fd = open(port->path, O_RDWR | O_NOCTTY | O_NONBLOCK)) < 0) {
+        return 0;
+    }
+    if (tcgetattr(port->fd, &tio) != 0) {
+        close(port->fd);
+        port->fd = -1;
+        return 0;
+    }
+    cfmakeraw(&tio);                            /* 8 data bits, no parity, no processing */
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, B115200);
+    cfsetospeed(&tio, B115200);
+    if (tcsetattr(port->fd, TCSANOW, &tio) != 0) {
+        close(port->fd);
+        port->fd = -1;
+        return 0;
+    }
+    return 1;
+}
+
+static uint8_t
+deinit(void* arg) {
+    ow_ll_posix_t* port = arg;
+
+    if (port->fd >= 0) {
+        close(port->fd);
+        port->fd = -1;
+    }
+    return 1;
+}
+
+static uint8_t
+set_baudrate(uint32_t baud, void* arg) {
+    ow_ll_posix_t* port = arg;
+    struct termios tio;
+    speed_t speed;
+
+    speed = baud == 9600 ? B9600 : B115200;
+    if (tcgetattr(port->fd, &tio) != 0) {
+        return 0;
+    }
+    if (cfgetospeed(&tio) == speed) {
+        return 1;                               /* Skip system call when baudrate does not change */
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+    return tcsetattr(port->fd, TCSANOW, &tio) == 0;
+}
+
+static uint8_t
+transmit_start(const uint8_t* tx, size_t len, void* arg) {
+    ow_ll_posix_t* port = arg;
+    ssize_t w;
+
+    /* Noise or aborted transfer may leave unaligned data in RX buffer */
+    tcflush(port->fd, TCIFLUSH);
+
+    /* Kernel buffer accepts complete chunk, write does not wait for transmission */
+    while (len > 0) {
+        if ((w = write(port->fd, tx, len)) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return 0;
+        }
+        tx += w;
+        len -= (size_t)w;
+    }
+    return 1;
+}
+
+static size_t
+receive_read(uint8_t* rx, size_t len, void* arg) {
+    ow_ll_posix_t* port = arg;
+    ssize_t r;
+
+    do {
+        r = read(port->fd, rx, len);
+    } while (r < 0 && errno == EINTR);
+    return r > 0 ? (size_t)r : 0;
+}
+
+static uint8_t
+transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg) {
+    ow_ll_posix_t* port = arg;
+    struct pollfd pfd = { .fd = port->fd, .events = POLLIN };
+    uint32_t start, elapsed;
+    size_t received = 0;
+
+    start = ow_ll_posix_get_time();
+    if (!transmit_start(tx, len, arg)) {
+        return 0;
+    }
+
+    /* Read same amount of data as sent previously (loopback), thread sleeps in poll */
+    while (received < len) {
+        elapsed = ow_ll_posix_get_time() - start;
+        if (elapsed >= timeout) {
+            return 0;                           /* Not all data received, adapter or line is stuck */
+        }
+        if (poll(&pfd, 1, (int)(timeout - elapsed)) > 0) {
+            received += receive_read(&rx[received], len - received, arg);
+        }
+    }
+    return 1;
+}
+
+static uint8_t
+transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
+    return transmit_receive_timeout(tx, rx, len, OW_LL_POSIX_TIMEOUT, arg);
+}
+
+#endif /* !__DOXYGEN__ */
+
+/**
+ * \brief           Get monotonic time
+ * \return          Time in units of milliseconds
+ */
+uint32_t
+ow_ll_posix_get_time(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000);
+}
+
+#if OW_CFG_ASYNC || __DOXYGEN__
+
+/**
+ * \brief           Initialize event loop
+ * \param[out]      loop: Event loop handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ll_posix_loop_init(ow_ll_posix_loop_t* const loop) {
+    OW_ASSERT("loop != NULL", loop != NULL);
+
+    loop->bus_count = 0;
+    if ((loop->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        return owERR;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           De-initialize event loop. Buses stay initialized
+ * \param[in]       loop: Event loop handle
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ll_posix_loop_deinit(ow_ll_posix_loop_t* const loop) {
+    OW_ASSERT("loop != NULL", loop != NULL);
+
+    close(loop->epfd);
+    loop->epfd = -1;
+    loop->bus_count = 0;
+    return owOK;
+}
+
+/**
+ * \brief           Register bus to event loop
+ * \param[in,out]   loop: Event loop handle
+ * \param[in]       async: Transaction handle of the bus, initialized with \ref ow_async_init.
+ *                      Its 1-Wire handle must use \ref ow_ll_drv_posix driver
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ll_posix_loop_add(ow_ll_posix_loop_t* const loop, ow_async_t* const async) {
+    struct epoll_event ev = { .events = EPOLLIN };
+    ow_ll_posix_t* port;
+
+    OW_ASSERT("loop != NULL", loop != NULL);
+    OW_ASSERT("async != NULL", async != NULL);
+    OW_ASSERT("async->ow->ll_drv == &ow_ll_drv_posix", async->ow->ll_drv == &ow_ll_drv_posix);
+
+    if (loop->bus_count >= OW_LL_POSIX_LOOP_BUSES) {
+        return owERR;
+    }
+    port = async->ow->arg;
+    ev.data.ptr = async;
+    if (epoll_ctl(loop->epfd, EPOLL_CTL_ADD, port->fd, &ev) != 0) {
+        return owERR;
+    }
+    loop->buses[loop->bus_count++] = async;
+    return owOK;
+}
+
+/**
+ * \brief           Wait for received data and advance transactions of all buses
+ *
+ * Function waits once for any bus to receive data. Transactions of buses with received data
+ * are advanced with \ref ow_async_process, their completion functions are called from this function.
+ * Transactions without received data for \ref OW_LL_POSIX_TIMEOUT are aborted with \ref owERRTIMEOUT.
+ *
+ * \code{c}
+ow_ll_posix_loop_init(&loop);
+for (size_t i = 0; i < bus_count; ++i) {
+    ow_init(&ow[i], &ow_ll_drv_posix, &port[i]);
+    ow_async_init(&async[i], &ow[i]);
+    ow_ll_posix_loop_add(&loop, &async[i]);
+    ow_async_start(&async[i], ops, OW_ARRAYSIZE(ops), done, NULL, ow_ll_posix_get_time());
+}
+while (1) {
+    ow_ll_posix_loop_run(&loop, 10);
+}
+\endcode
+ *
+ * \param[in,out]   loop: Event loop handle
+ * \param[in]       timeout: Maximal time to wait for data in units of milliseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_ll_posix_loop_run(ow_ll_posix_loop_t* const loop, const uint32_t timeout) {
+    struct epoll_event evs[OW_LL_POSIX_LOOP_BUSES];
+    uint32_t now;
+    int n;
+
+    OW_ASSERT("loop != NULL", loop != NULL);
+
+    if ((n = epoll_wait(loop->epfd, evs, OW_LL_POSIX_LOOP_BUSES, (int)timeout)) < 0 && errno != EINTR) {
+        return owERR;
+    }
+    now = ow_ll_posix_get_time();
+    for (int i = 0; i < n; ++i) {
+        ow_async_process(evs[i].data.ptr, now);
+    }
+    for (size_t i = 0; i < loop->bus_count; ++i) {
+        ow_async_check_timeout(loop->buses[i], now, OW_LL_POSIX_TIMEOUT);
+    }
+    return owOK;
+}
+
+#endif /* OW_CFG_ASYNC || __DOXYGEN__ */
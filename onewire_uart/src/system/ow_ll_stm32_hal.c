@@ -38,7 +38,12 @@
  * https://docs.majerle.eu/projects/onewire-uart/en/latest/user-manual/hw_connection.html#
  *
  * This specific driver is optimized for proejcts generated by STM32CubeMX or STM32CubeIDE with HAL drivers
- * It can be used w/ or w/o operating system and it uses interrupts & polling for data receive and data transmit.
+ * It can be used w/ or w/o operating system and it uses interrupts for data receive.
+ *
+ * Without operating system, data are transmitted in polling mode and driver polls for receive to complete.
+ * With operating system, data are transmitted in interrupt mode too and calling thread sleeps
+ * on semaphore (see ow_sys_sem_wait), until receive complete interrupt releases it.
+ * CPU is free for other threads during complete transfer.
  *
  * Application must pass pointer to UART handle as argument to ow_init function in order
  * to link OW instance with actual UART hardware used for OW instance.
@@ -46,16 +51,43 @@
  * To use this driver, application must:
  * - Enable interrupt in CubeMX to allow HAL_UART_Receive_IT functionality
  * - Use pointer to UART handle when initializing ow with ow_init
+ * - With operating system, call ow_ll_stm32_hal_rx_complete from HAL_UART_RxCpltCallback,
+ *      or leave OW_LL_STM32_HAL_RX_CALLBACK enabled to let driver implement the callback
  */
 #include "ow/ow.h"
 #include "main.h"                               /* Generated normally by CubeMX */
 
 #if !__DOXYGEN__
 
+#if OW_CFG_OS
+
+/* Maximal number of UARTs used for 1-Wire at the same time */
+#ifndef OW_LL_STM32_HAL_UARTS
+#define OW_LL_STM32_HAL_UARTS                   4
+#endif
+
+/* Set to 0 when application implements HAL_UART_RxCpltCallback itself */
+#ifndef OW_LL_STM32_HAL_RX_CALLBACK
+#define OW_LL_STM32_HAL_RX_CALLBACK             1
+#endif
+
+/* Semaphore of each UART, released from receive complete interrupt */
+typedef struct {
+    UART_HandleTypeDef* huart;
+    OW_CFG_OS_SEM_HANDLE sem;
+} uart_sem_t;
+
+static uart_sem_t uarts[OW_LL_STM32_HAL_UARTS];
+
+void ow_ll_stm32_hal_rx_complete(UART_HandleTypeDef* huart);
+
+#endif /* OW_CFG_OS */
+
 static uint8_t init(void* arg);
 static uint8_t deinit(void* arg);
 static uint8_t set_baudrate(uint32_t baud, void* arg);
 static uint8_t transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg);
+static uint8_t transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg);
 
 /* STM32 LL driver for OW */
 const ow_ll_drv_t
@@ -64,14 +96,59 @@ ow_ll_drv_stm32_hal = {
     .deinit = deinit,
     .set_baudrate = set_baudrate,
     .tx_rx = transmit_receive,
+    .tx_rx_timeout = transmit_receive_timeout,
 };
 
+#if OW_CFG_OS
+
+/* Get semaphore entry of UART, NULL if UART is not initialized */
+static uart_sem_t*
+get_sem(UART_HandleTypeDef* huart) {
+    for (size_t i = 0; i < OW_ARRAYSIZE(uarts); ++i) {
+        if (uarts[i].huart == huart) {
+            return &uarts[i];
+        }
+    }
+    return NULL;
+}
+
+/* Release thread waiting for transfer to complete. Called from interrupt context */
+void
+ow_ll_stm32_hal_rx_complete(UART_HandleTypeDef* huart) {
+    uart_sem_t* u;
+
+    if ((u = get_sem(huart)) != NULL) {
+        ow_sys_sem_release(&u->sem, huart);
+    }
+}
+
+#if OW_LL_STM32_HAL_RX_CALLBACK
+void
+HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+    ow_ll_stm32_hal_rx_complete(huart);
+}
+#endif /* OW_LL_STM32_HAL_RX_CALLBACK */
+
+#endif /* OW_CFG_OS */
+
 static uint8_t
 init(void* arg) {
     UART_HandleTypeDef* huart = arg;
 
     OW_ASSERT0("arg != NULL", arg != NULL);
 
+#if OW_CFG_OS
+    /* Create semaphore on first init, init is called again on each baudrate change */
+    if (get_sem(huart) == NULL) {
+        uart_sem_t* u;
+
+        if ((u = get_sem(NULL)) == NULL || !ow_sys_sem_create(&u->sem, arg)) {
+            return 0;
+        }
+        u->huart = huart;
+    }
+#endif /* OW_CFG_OS */
+
     /* Initialize UART */
     HAL_UART_DeInit(huart);
     return HAL_UART_Init(huart) == HAL_OK;
@@ -83,6 +160,16 @@ deinit(void* arg) {
 
     OW_ASSERT0("arg != NULL", arg != NULL);
 
+#if OW_CFG_OS
+    {
+        uart_sem_t* u;
+
+        if ((u = get_sem(huart)) != NULL) {
+            u->huart = NULL;
+            ow_sys_sem_delete(&u->sem, arg);
+        }
+    }
+#endif /* OW_CFG_OS */
     return HAL_UART_DeInit(huart);
 }
 
@@ -97,7 +184,7 @@ set_baudrate(uint32_t baud, void* arg) {
 }
 
 static uint8_t
-transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
+transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg) {
     UART_HandleTypeDef* huart = arg;
     uint32_t start;
 
@@ -107,19 +194,65 @@ transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
     start = HAL_GetTick();
 
     /* Start RX in interrupt mode */
-    HAL_UART_Receive_IT(huart, rx, len);
+    if (HAL_UART_Receive_IT(huart, rx, len) != HAL_OK) {
+        return 0;
+    }
+
+#if OW_CFG_OS
+    {
+        uart_sem_t* u = get_sem(huart);
+        uint32_t elapsed;
 
+        /* Process TX in interrupt mode */
+        if (u == NULL || HAL_UART_Transmit_IT(huart, (void *)tx, len) != HAL_OK) {
+            HAL_UART_Abort(huart);
+            return 0;
+        }
+
+        /*
+         * Sleep until RX completes.
+         * Semaphore may already hold late release of previously aborted transfer,
+         * RX state is therefore checked after each wake-up
+         */
+        while (huart->RxState != HAL_UART_STATE_READY) {
+            elapsed = HAL_GetTick() - start;
+            if (elapsed >= timeout || (!ow_sys_sem_wait(&u->sem, timeout - elapsed, arg)
+                                       && huart->RxState != HAL_UART_STATE_READY)) {
+                HAL_UART_Abort(huart);          /* Stop RX and TX, next transfer starts from clean state */
+                return 0;
+            }
+        }
+
+        /* Last byte is received together with end of its transmission */
+        while (huart->gState != HAL_UART_STATE_READY) {
+            if (HAL_GetTick() - start > timeout) {
+                HAL_UART_Abort(huart);
+                return 0;
+            }
+        }
+    }
+#else
     /* Process TX in polling mode */
-    HAL_UART_Transmit(huart, (void *)tx, len, 100);
+    if (HAL_UART_Transmit(huart, (void *)tx, len, timeout) != HAL_OK) {
+        HAL_UART_AbortReceive(huart);
+        return 0;
+    }
 
     /* Wait RX to finish */
     while (huart->RxState != HAL_UART_STATE_READY) {
-        if (HAL_GetTick() - start > 100) {
+        if (HAL_GetTick() - start > timeout) {
+            HAL_UART_AbortReceive(huart);       /* Stop RX, next transfer starts from clean state */
             return 0;
         }
     }
+#endif /* OW_CFG_OS */
 
     return 1;
 }
 
+static uint8_t
+transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
+    return transmit_receive_timeout(tx, rx, len, 100, arg);
+}
+
 #endif /* !__DOXYGEN__ */
@@ -0,0 +1,280 @@
+/**
+ * \file            ow_ll_stm32_hal_dma.c
+ * \brief           UART driver implementation for STM32 with HAL code and DMA
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+
+/*
+ * How it works (general)
+ *
+ * https://docs.majerle.eu/projects/onewire-uart/en/latest/user-manual/hw_connection.html#
+ *
+ * This specific driver is optimized for proejcts generated by STM32CubeMX or STM32CubeIDE with HAL drivers
+ * It can be used w/ or w/o operating system and it uses DMA for data receive and data transmit.
+ *
+ * Complete encoded transfer is exchanged with single DMA transfer in each direction, CPU is not involved per byte.
+ * With operating system, calling thread sleeps on semaphore (see ow_sys_sem_wait),
+ * until receive complete interrupt releases it. Without operating system, driver polls for receive to complete.
+ *
+ * UART is fully initialized only once. Baudrate register values for reset and data baudrates
+ * are calculated by HAL on first initialization and written directly to BRR register on each baudrate change.
+ *
+ * Application must pass pointer to UART handle as argument to ow_init function in order
+ * to link OW instance with actual UART hardware used for OW instance.
+ *
+ * To use this driver, application must:
+ * - Configure DMA channels for UART RX and TX in CubeMX, together with DMA and UART interrupts
+ * - Use pointer to UART handle when initializing ow with ow_init
+ * - Place thread stacks in DMA accessible memory, as transfer buffers are allocated on the stack
+ * - With operating system, call ow_ll_stm32_hal_dma_rx_complete from HAL_UART_RxCpltCallback,
+ *      or leave OW_LL_STM32_HAL_DMA_RX_CALLBACK enabled to let driver implement the callback
+ *
+ * Driver shall not be used together with ow_ll_stm32_hal.c driver, when both implement HAL_UART_RxCpltCallback
+ */
+#include "ow/ow.h"
+#include "main.h"                               /* Generated normally by CubeMX */
+
+#if !__DOXYGEN__
+
+/* Maximal number of UARTs used for 1-Wire at the same time */
+#ifndef OW_LL_STM32_HAL_DMA_UARTS
+#define OW_LL_STM32_HAL_DMA_UARTS               4
+#endif
+
+/* Set to 0 when application implements HAL_UART_RxCpltCallback itself */
+#ifndef OW_LL_STM32_HAL_DMA_RX_CALLBACK
+#define OW_LL_STM32_HAL_DMA_RX_CALLBACK         1
+#endif
+
+/* State of each UART */
+typedef struct {
+    UART_HandleTypeDef* huart;
+    uint32_t brr_reset;                         /* BRR register value for reset baudrate */
+    uint32_t brr_data;                          /* BRR register value for data baudrate */
+#if OW_CFG_OS
+    OW_CFG_OS_SEM_HANDLE sem;                   /* Released from receive complete interrupt */
+#endif /* OW_CFG_OS */
+} uart_dma_t;
+
+static uart_dma_t uarts[OW_LL_STM32_HAL_DMA_UARTS];
+
+static uint8_t init(void* arg);
+static uint8_t deinit(void* arg);
+static uint8_t set_baudrate(uint32_t baud, void* arg);
+static uint8_t transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg);
+static uint8_t transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg);
+
+/* STM32 HAL DMA driver for OW */
+const ow_ll_drv_t
+ow_ll_drv_stm32_hal_dma = {
+    .init = init,
+    .deinit = deinit,
+    .set_baudrate = set_baudrate,
+    .tx_rx = transmit_receive,
+    .tx_rx_timeout = transmit_receive_timeout,
+};
+
+/* Get state of UART, NULL if UART is not initialized */
+static uart_dma_t*
+get_uart(UART_HandleTypeDef* huart) {
+    for (size_t i = 0; i < OW_ARRAYSIZE(uarts); ++i) {
+        if (uarts[i].huart == huart) {
+            return &uarts[i];
+        }
+    }
+    return NULL;
+}
+
+#if OW_CFG_OS
+
+void ow_ll_stm32_hal_dma_rx_complete(UART_HandleTypeDef* huart);
+
+/* Release thread waiting for transfer to complete. Called from interrupt context */
+void
+ow_ll_stm32_hal_dma_rx_complete(UART_HandleTypeDef* huart) {
+    uart_dma_t* u;
+
+    if ((u = get_uart(huart)) != NULL) {
+        ow_sys_sem_release(&u->sem, huart);
+    }
+}
+
+#if OW_LL_STM32_HAL_DMA_RX_CALLBACK
+void
+HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart) {
+    ow_ll_stm32_hal_dma_rx_complete(huart);
+}
+#endif /* OW_LL_STM32_HAL_DMA_RX_CALLBACK */
+
+#endif /* OW_CFG_OS */
+
+static uint8_t
+init(void* arg) {
+    UART_HandleTypeDef* huart = arg;
+    uart_dma_t* u;
+
+    OW_ASSERT0("arg != NULL", arg != NULL);
+
+    if (get_uart(huart) != NULL) {
+        return 1;                               /* Already initialized */
+    }
+    if ((u = get_uart(NULL)) == NULL) {
+        return 0;
+    }
+
+    /* Let HAL calculate register values for both baudrates, UART is left at data baudrate */
+    HAL_UART_DeInit(huart);
+    huart->Init.BaudRate = OW_BAUD_RESET;
+    if (HAL_UART_Init(huart) != HAL_OK) {
+        return 0;
+    }
+    u->brr_reset = huart->Instance->BRR;
+    HAL_UART_DeInit(huart);
+    huart->Init.BaudRate = OW_BAUD_DATA;
+    if (HAL_UART_Init(huart) != HAL_OK) {
+        return 0;
+    }
+    u->brr_data = huart->Instance->BRR;
+
+#if OW_CFG_OS
+    if (!ow_sys_sem_create(&u->sem, arg)) {
+        HAL_UART_DeInit(huart);
+        return 0;
+    }
+#endif /* OW_CFG_OS */
+    u->huart = huart;
+    return 1;
+}
+
+static uint8_t
+deinit(void* arg) {
+    UART_HandleTypeDef* huart = arg;
+    uart_dma_t* u;
+
+    OW_ASSERT0("arg != NULL", arg != NULL);
+
+    if ((u = get_uart(huart)) != NULL) {
+        u->huart = NULL;
+#if OW_CFG_OS
+        ow_sys_sem_delete(&u->sem, arg);
+#endif /* OW_CFG_OS */
+    }
+    return HAL_UART_DeInit(huart) == HAL_OK;
+}
+
+static uint8_t
+set_baudrate(uint32_t baud, void* arg) {
+    UART_HandleTypeDef* huart = arg;
+    uart_dma_t* u;
+
+    OW_ASSERT0("arg != NULL", arg != NULL);
+
+    if ((u = get_uart(huart)) == NULL || (baud != OW_BAUD_RESET && baud != OW_BAUD_DATA)) {
+        return 0;
+    }
+
+    /* Baudrate register may only be written while UART is disabled */
+    __HAL_UART_DISABLE(huart);
+    huart->Instance->BRR = baud == OW_BAUD_RESET ? u->brr_reset : u->brr_data;
+    huart->Init.BaudRate = baud;
+    __HAL_UART_ENABLE(huart);
+    return 1;
+}
+
+static uint8_t
+transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg) {
+    UART_HandleTypeDef* huart = arg;
+    uart_dma_t* u;
+    uint32_t start;
+
+    OW_ASSERT0("arg != NULL", arg != NULL);
+
+    if ((u = get_uart(huart)) == NULL) {
+        return 0;
+    }
+
+    /* Get current HAL tick */
+    start = HAL_GetTick();
+
+    /* Start RX before TX, first byte is received while second is being transmitted */
+    if (HAL_UART_Receive_DMA(huart, rx, len) != HAL_OK) {
+        return 0;
+    }
+    if (HAL_UART_Transmit_DMA(huart, (void *)tx, len) != HAL_OK) {
+        HAL_UART_Abort(huart);
+        return 0;
+    }
+
+#if OW_CFG_OS
+    {
+        uint32_t elapsed;
+
+        /*
+         * Sleep until RX completes.
+         * Semaphore may already hold late release of previously aborted transfer,
+         * RX state is therefore checked after each wake-up
+         */
+        while (huart->RxState != HAL_UART_STATE_READY) {
+            elapsed = HAL_GetTick() - start;
+            if (elapsed >= timeout || (!ow_sys_sem_wait(&u->sem, timeout - elapsed, arg)
+                                       && huart->RxState != HAL_UART_STATE_READY)) {
+                HAL_UART_Abort(huart);          /* Stop both DMA streams, next transfer starts from clean state */
+                return 0;
+            }
+        }
+    }
+#else
+    /* Wait RX to finish */
+    while (huart->RxState != HAL_UART_STATE_READY) {
+        if (HAL_GetTick() - start > timeout) {
+            HAL_UART_Abort(huart);              /* Stop both DMA streams, next transfer starts from clean state */
+            return 0;
+        }
+    }
+#endif /* OW_CFG_OS */
+
+    /* Last byte is received together with end of its transmission */
+    while (huart->gState != HAL_UART_STATE_READY) {
+        if (HAL_GetTick() - start > timeout) {
+            HAL_UART_Abort(huart);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static uint8_t
+transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
+    return transmit_receive_timeout(tx, rx, len, 100, arg);
+}
+
+#endif /* !__DOXYGEN__ */
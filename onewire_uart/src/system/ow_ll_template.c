@@ -84,3 +84,34 @@ ow_ll_transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
 
     return 1;
 }
+
+/**
+ * \brief           Transmit-Receive data over UART within limited time
+ * \note            Optional function, leave it out of driver structure if exchange cannot be aborted
+ * \param[in]       tx: Array of data to send
+ * \param[out]      rx: Array to save receive data
+ * \param[in]       len: Number of bytes to send
+ * \param[in]       timeout: Maximal exchange time in units of milliseconds
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` on timeout or error
+ */
+uint8_t
+ow_ll_transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg) {
+    /* Perform data exchange, abort it when timeout expires */
+
+    return 1;
+}
+
+/**
+ * \brief           Enable or disable strong pullup on 1-Wire line
+ * \note            Optional function, leave it out of driver structure if hardware has no strong pullup
+ * \param[in]       enable: Set to `1` to enable strong pullup, `0` to disable it
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_ll_strong_pullup(uint8_t enable, void* arg) {
+    /* Drive external MOSFET to connect line directly to supply */
+
+    return 1;
+}
@@ -42,6 +42,7 @@ static uint8_t init(void* arg);
 static uint8_t deinit(void* arg);
 static uint8_t set_baudrate(uint32_t baud, void* arg);
 static uint8_t transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg);
+static uint8_t transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg);
 
 /* Win 32 LL driver for OW */
 const ow_ll_drv_t
@@ -50,10 +51,29 @@ ow_ll_drv_win32 = {
     .deinit = deinit,
     .set_baudrate = set_baudrate,
     .tx_rx = transmit_receive,
+    .tx_rx_timeout = transmit_receive_timeout,
 };
 
 static HANDLE com_port;
 static DCB dcb = { 0 };
+static DWORD read_timeout;
+
+/* Set time ReadFile blocks for, when not all requested data are received */
+static uint8_t
+set_read_timeout(DWORD ms) {
+    COMMTIMEOUTS timeouts = { 0 };
+
+    if (ms == read_timeout) {
+        return 1;
+    }
+    timeouts.ReadTotalTimeoutConstant = ms;
+    if (!SetCommTimeouts(com_port, &timeouts)) {
+        printf("Cannot set COM PORT timeouts\r\n");
+        return 0;
+    }
+    read_timeout = ms;
+    return 1;
+}
 
 static uint8_t
 init(void* arg) {
@@ -71,8 +91,6 @@ init(void* arg) {
 
     /* First read current values */
     if (GetCommState(com_port, &dcb)) {
-        COMMTIMEOUTS timeouts;
-
         dcb.BaudRate = 115200;
         dcb.ByteSize = 8;
         dcb.Parity = NOPARITY;
@@ -84,16 +102,9 @@ init(void* arg) {
             return 0;
         }
 
-        if (GetCommTimeouts(com_port, &timeouts)) {
-            /* Set timeout to return immediatelly from ReadFile function */
-            timeouts.ReadIntervalTimeout = MAXDWORD;
-            timeouts.ReadTotalTimeoutConstant = 0;
-            timeouts.ReadTotalTimeoutMultiplier = 0;
-            if (!SetCommTimeouts(com_port, &timeouts)) {
-                printf("Cannot set COM PORT timeouts\r\n");
-            }
-            GetCommTimeouts(com_port, &timeouts);
-        }
+        /* ReadFile blocks thread until all data are received, instead of returning immediately */
+        read_timeout = 0;
+        set_read_timeout(1000);
     } else {
         printf("Cannot get COM port info\r\n");
     }
@@ -123,10 +134,10 @@ set_baudrate(uint32_t baud, void* arg) {
 }
 
 uint8_t
-transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
+transmit_receive_timeout(const uint8_t* tx, uint8_t* rx, size_t len, uint32_t timeout, void* arg) {
     /* Perform data exchange */
     size_t read = 0;
-    DWORD br;
+    DWORD br, start, elapsed;
 
     if (com_port != NULL) {
         /*
@@ -140,11 +151,16 @@ transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
         PurgeComm(com_port, PURGE_RXCLEAR | PURGE_RXABORT);
 
         /* Write file and send data */
+        start = GetTickCount();
         WriteFile(com_port, tx, len, &br, NULL);
         FlushFileBuffers(com_port);
 
-        /* Read same amount of data as sent previously (loopback) */
+        /* Read same amount of data as sent previously (loopback), thread sleeps in ReadFile */
         do {
+            elapsed = GetTickCount() - start;
+            if (elapsed >= timeout || !set_read_timeout(timeout - elapsed)) {
+                return 0;                       /* Not all data received, adapter or line is stuck */
+            }
             if (ReadFile(com_port, rx, (DWORD)(len - read), &br, NULL)) {
                 read += (size_t)br;
                 rx += (size_t)br;
@@ -155,4 +171,9 @@ transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
     return 1;
 }
 
+uint8_t
+transmit_receive(const uint8_t* tx, uint8_t* rx, size_t len, void* arg) {
+    return transmit_receive_timeout(tx, rx, len, 1000, arg);
+}
+
 #endif /* !__DOXYGEN__ */
@@ -37,6 +37,23 @@
 
 #include "cmsis_os.h"
 
+/**
+ * \brief           Convert time in units of milliseconds to kernel ticks
+ * \param[in]       ms: Time in units of milliseconds
+ * \return          Number of kernel ticks, rounded up to not wake up early
+ */
+static uint32_t
+prv_ms_to_ticks(const uint32_t ms) {
+    uint32_t freq = osKernelGetTickFreq();
+    uint64_t ticks;
+
+    if (freq == 1000U) {
+        return ms;
+    }
+    ticks = ((uint64_t)ms * freq + 999U) / 1000U;
+    return ticks < osWaitForever ? (uint32_t)ticks : osWaitForever - 1U;
+}
+
 uint8_t
 ow_sys_mutex_create(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     const osMutexAttr_t attr = {
@@ -64,6 +81,12 @@ ow_sys_mutex_wait(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     return 1;
 }
 
+uint8_t
+ow_sys_mutex_wait_timeout(OW_CFG_OS_MUTEX_HANDLE* mutex, const uint32_t timeout, void* arg) {
+    OW_UNUSED(arg);
+    return osMutexAcquire(*mutex, prv_ms_to_ticks(timeout)) == osOK;
+}
+
 uint8_t
 ow_sys_mutex_release(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     if (osMutexRelease(*mutex) != osOK) {
@@ -73,4 +96,63 @@ ow_sys_mutex_release(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     return 1;
 }
 
+uint8_t
+ow_sys_delay(const uint32_t ms, void* arg) {
+    OW_UNUSED(arg);
+    return osDelay(prv_ms_to_ticks(ms)) == osOK;
+}
+
+uint32_t
+ow_sys_get_tick(void* arg) {
+    static uint32_t last, ms, rem;
+    uint32_t freq = osKernelGetTickFreq(), now;
+    uint64_t acc;
+    int32_t lock;
+
+    OW_UNUSED(arg);
+    if (freq == 1000U) {
+        return osKernelGetTickCount();
+    }
+
+    /* Accumulate elapsed ticks, millisecond time wraps at 32-bit as with 1 kHz kernel tick */
+    lock = osKernelLock();
+    now = osKernelGetTickCount();
+    acc = (uint64_t)(now - last) * 1000U + rem;
+    last = now;
+    ms += (uint32_t)(acc / freq);
+    rem = (uint32_t)(acc % freq);
+    now = ms;
+    if (lock >= 0) {
+        osKernelRestoreLock(lock);
+    }
+    return now;
+}
+
+uint8_t
+ow_sys_sem_create(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    OW_UNUSED(arg);
+    *sem = osSemaphoreNew(0xFFFF, 0, NULL);     /* Create counting semaphore, initially not available */
+    return *sem != NULL;
+}
+
+uint8_t
+ow_sys_sem_delete(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    OW_UNUSED(arg);
+    osSemaphoreDelete(*sem);                    /* Delete semaphore */
+    *sem = NULL;
+    return 1;
+}
+
+uint8_t
+ow_sys_sem_wait(OW_CFG_OS_SEM_HANDLE* sem, const uint32_t timeout, void* arg) {
+    OW_UNUSED(arg);
+    return osSemaphoreAcquire(*sem, timeout > 0 ? prv_ms_to_ticks(timeout) : osWaitForever) == osOK;
+}
+
+uint8_t
+ow_sys_sem_release(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    OW_UNUSED(arg);
+    return osSemaphoreRelease(*sem) == osOK;
+}
+
 #endif /* OW_CFG_OS && !__DOXYGEN__ */
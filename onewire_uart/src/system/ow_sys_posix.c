@@ -0,0 +1,491 @@
+/**
+ * \file            ow_sys_posix.c
+ * \brief           System functions for POSIX with real-time profile for Linux
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE                             /* CPU affinity and monotonic clock waits */
+#endif
+#include <errno.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "system/ow_sys_posix.h"
+
+#if OW_CFG_OS
+
+#if !__DOXYGEN__
+
+/* Get absolute monotonic time, `ms` from now */
+static struct timespec
+prv_abs_time(const uint32_t ms) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ++ts.tv_sec;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return ts;
+}
+
+uint8_t
+ow_sys_mutex_create(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
+    pthread_mutexattr_t attr;
+    pthread_mutex_t* m;
+
+    OW_UNUSED(arg);
+    if ((m = malloc(sizeof(*m))) == NULL) {
+        return 0;
+    }
+
+    /* Recursive, same as mutexes of other ports */
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+    if (pthread_mutex_init(m, &attr) != 0) {
+        pthread_mutexattr_destroy(&attr);
+        free(m);
+        return 0;
+    }
+    pthread_mutexattr_destroy(&attr);
+    *mutex = m;
+    return 1;
+}
+
+uint8_t
+ow_sys_mutex_delete(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
+    OW_UNUSED(arg);
+    pthread_mutex_destroy(*mutex);
+    free(*mutex);
+    *mutex = NULL;
+    return 1;
+}
+
+uint8_t
+ow_sys_mutex_wait(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
+    OW_UNUSED(arg);
+    return pthread_mutex_lock(*mutex) == 0;
+}
+
+uint8_t
+ow_sys_mutex_wait_timeout(OW_CFG_OS_MUTEX_HANDLE* mutex, const uint32_t timeout, void* arg) {
+    struct timespec ts = prv_abs_time(timeout);
+
+    OW_UNUSED(arg);
+    return pthread_mutex_clocklock(*mutex, CLOCK_MONOTONIC, &ts) == 0;
+}
+
+uint8_t
+ow_sys_mutex_release(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
+    OW_UNUSED(arg);
+    return pthread_mutex_unlock(*mutex) == 0;
+}
+
+uint8_t
+ow_sys_delay(const uint32_t ms, void* arg) {
+    struct timespec ts = prv_abs_time(ms);
+
+    OW_UNUSED(arg);
+    /* Absolute wake-up time does not drift when sleep is interrupted */
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {}
+    return 1;
+}
+
+uint32_t
+ow_sys_get_tick(void* arg) {
+    struct timespec ts;
+
+    OW_UNUSED(arg);
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000);
+}
+
+uint8_t
+ow_sys_sem_create(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    sem_t* s;
+
+    OW_UNUSED(arg);
+    if ((s = malloc(sizeof(*s))) == NULL) {
+        return 0;
+    }
+    if (sem_init(s, 0, 0) != 0) {
+        free(s);
+        return 0;
+    }
+    *sem = s;
+    return 1;
+}
+
+uint8_t
+ow_sys_sem_delete(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    OW_UNUSED(arg);
+    sem_destroy(*sem);
+    free(*sem);
+    *sem = NULL;
+    return 1;
+}
+
+uint8_t
+ow_sys_sem_wait(OW_CFG_OS_SEM_HANDLE* sem, const uint32_t timeout, void* arg) {
+    struct timespec ts;
+    int r;
+
+    OW_UNUSED(arg);
+    if (timeout == 0) {
+        while ((r = sem_wait(*sem)) != 0 && errno == EINTR) {}
+    } else {
+        ts = prv_abs_time(timeout);
+        while ((r = sem_clockwait(*sem, CLOCK_MONOTONIC, &ts)) != 0 && errno == EINTR) {}
+    }
+    return r == 0;
+}
+
+uint8_t
+ow_sys_sem_release(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    OW_UNUSED(arg);
+    return sem_post(*sem) == 0;
+}
+
+#endif /* !__DOXYGEN__ */
+
+/**
+ * \brief           Get monotonic time with microsecond resolution
+ * \return          Time in units of microseconds
+ */
+uint32_t
+ow_sys_posix_get_time_us(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000);
+}
+
+/**
+ * \brief           Lock memory of the process and prefault stack and heap
+ *
+ * Function shall be called once at startup, before bus threads are created.
+ * All current and future pages stay resident, page faults do not delay transfers.
+ * Heap is grown by `heap_size` bytes and never returned to the system,
+ * memory of semaphores and mutexes is allocated from it without faults.
+ *
+ * \note            Process needs `CAP_IPC_LOCK` capability or sufficient `RLIMIT_MEMLOCK` limit
+ * \param[in]       stack_size: Number of stack bytes of calling thread to prefault
+ * \param[in]       heap_size: Number of heap bytes to prefault
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_rt_lock_memory(const size_t stack_size, const size_t heap_size) {
+    volatile uint8_t* p;
+    void* heap;
+
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        return owERR;
+    }
+
+    /* Freed heap memory stays in the process */
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+    if (heap_size > 0) {
+        if ((heap = malloc(heap_size)) == NULL) {
+            return owERR;
+        }
+        memset(heap, 0x00, heap_size);
+        free(heap);
+    }
+
+    /* Touch stack pages, they stay locked afterwards */
+    if (stack_size > 0) {
+        p = alloca(stack_size);
+        for (size_t i = 0; i < stack_size; i += 256) {
+            p[i] = 0;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Apply real-time profile to calling thread
+ *
+ * Thread of each bus can be pinned to its own CPU, isolated from other load
+ *
+ * \note            Process needs `CAP_SYS_NICE` capability or sufficient `RLIMIT_RTPRIO` limit
+ * \param[in]       rt: Real-time profile
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_rt_setup(const ow_sys_posix_rt_t* const rt) {
+    struct sched_param param = { 0 };
+    cpu_set_t set;
+
+    OW_ASSERT("rt != NULL", rt != NULL);
+
+    if (rt->cpu >= 0) {
+        CPU_ZERO(&set);
+        CPU_SET(rt->cpu, &set);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            return owERR;
+        }
+    }
+    if (rt->priority > 0) {
+        param.sched_priority = rt->priority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            return owERR;
+        }
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Initialize empty histogram
+ * \param[out]      hist: Histogram handle
+ * \param[in]       bin_us: Width of single bin in units of microseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_hist_init(ow_sys_posix_hist_t* const hist, const uint32_t bin_us) {
+    OW_ASSERT("hist != NULL", hist != NULL);
+    OW_ASSERT("bin_us > 0", bin_us > 0);
+
+    memset(hist, 0x00, sizeof(*hist));
+    hist->bin_us = bin_us;
+    hist->min_us = UINT32_MAX;
+    return owOK;
+}
+
+/**
+ * \brief           Add sample to histogram
+ * \param[in,out]   hist: Histogram handle
+ * \param[in]       us: Sample in units of microseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_hist_add(ow_sys_posix_hist_t* const hist, const uint32_t us) {
+    uint32_t bin;
+
+    OW_ASSERT("hist != NULL", hist != NULL);
+
+    if ((bin = us / hist->bin_us) < OW_SYS_POSIX_HIST_BINS) {
+        ++hist->bins[bin];
+    } else {
+        ++hist->overflow;
+    }
+    ++hist->count;
+    hist->total_us += us;
+    if (us < hist->min_us) {
+        hist->min_us = us;
+    }
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Get latency below which given percentage of samples lie
+ * \param[in]       hist: Histogram handle
+ * \param[in]       percent: Percentage of samples, between `0` and `100`
+ * \return          Upper bound of the bin in units of microseconds,
+ *                      highest sample when percentile falls to overflow, `0` when histogram is empty
+ */
+uint32_t
+ow_sys_posix_hist_get_percentile(const ow_sys_posix_hist_t* const hist, const uint8_t percent) {
+    uint64_t need, sum = 0;
+
+    OW_ASSERT0("hist != NULL", hist != NULL);
+
+    if (hist->count == 0) {
+        return 0;
+    }
+    need = ((uint64_t)hist->count * percent + 99) / 100;
+    for (uint32_t i = 0; i < OW_SYS_POSIX_HIST_BINS; ++i) {
+        sum += hist->bins[i];
+        if (sum >= need && sum > 0) {
+            return (i + 1) * hist->bin_us;
+        }
+    }
+    return hist->max_us;
+}
+
+#if OW_CFG_WORKER || __DOXYGEN__
+
+#if !__DOXYGEN__
+/* Operation timed by jitter monitor */
+typedef struct {
+    ow_work_fn fn;
+    void* arg;
+    ow_sys_posix_monitor_t* monitor;
+    uint32_t submitted;
+} ow_sys_posix_timed_t;
+
+/* Monitor read request */
+typedef struct {
+    ow_sys_posix_monitor_t* monitor;
+    ow_sys_posix_monitor_t* out;
+    uint8_t clear;
+} ow_sys_posix_read_t;
+#endif /* !__DOXYGEN__ */
+
+/**
+ * \brief           Execute operation and record its latency, runs in worker thread
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       arg: Timed operation
+ * \return          Result of operation function
+ */
+static owr_t
+prv_timed(ow_t* const ow, void* arg) {
+    ow_sys_posix_timed_t* t = arg;
+    uint32_t start;
+    owr_t res;
+
+    start = ow_sys_posix_get_time_us();
+    ow_sys_posix_hist_add(&t->monitor->wait, start - t->submitted);
+    res = t->fn(ow, t->arg);
+    ow_sys_posix_hist_add(&t->monitor->exec, ow_sys_posix_get_time_us() - start);
+    return res;
+}
+
+/**
+ * \brief           Copy monitor histograms, runs in worker thread
+ * \param[in]       ow: 1-Wire handle
+ * \param[in]       arg: Read request
+ * \return          \ref owOK on success
+ */
+static owr_t
+prv_read(ow_t* const ow, void* arg) {
+    ow_sys_posix_read_t* r = arg;
+
+    OW_UNUSED(ow);
+    *r->out = *r->monitor;
+    if (r->clear) {
+        ow_sys_posix_monitor_init(r->monitor, r->monitor->wait.bin_us);
+    }
+    return owOK;
+}
+
+/**
+ * \brief           Worker thread body with real-time profile, pass to `pthread_create`
+ *
+ * \code{c}
+static ow_sys_posix_worker_t bus_thread = { .worker = &worker, .rt = { .priority = 80, .cpu = 2 } };
+pthread_t thread;
+
+ow_sys_posix_rt_lock_memory(64 * 1024, 256 * 1024);
+ow_worker_init(&worker, &ow);
+pthread_create(&thread, NULL, ow_sys_posix_worker_thread, &bus_thread);
+\endcode
+ *
+ * \param[in]       arg: Worker thread of type \ref ow_sys_posix_worker_t
+ * \return          `NULL`, result is written to `res` member
+ */
+void*
+ow_sys_posix_worker_thread(void* arg) {
+    ow_sys_posix_worker_t* w = arg;
+
+    OW_ASSERT0("w != NULL", w != NULL);
+
+    if ((w->res = ow_sys_posix_rt_setup(&w->rt)) == owOK) {
+        w->res = ow_worker_run(w->worker);
+    }
+    return NULL;
+}
+
+/**
+ * \brief           Initialize jitter monitor with empty histograms
+ * \param[out]      monitor: Monitor handle
+ * \param[in]       bin_us: Width of histogram bin in units of microseconds
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_monitor_init(ow_sys_posix_monitor_t* const monitor, const uint32_t bin_us) {
+    OW_ASSERT("monitor != NULL", monitor != NULL);
+
+    ow_sys_posix_hist_init(&monitor->wait, bin_us);
+    return ow_sys_posix_hist_init(&monitor->exec, bin_us);
+}
+
+/**
+ * \brief           Submit request to worker, wait for completion and record its latency
+ *
+ * Histograms are updated by worker thread only, monitor may be shared by all clients of the worker
+ *
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request handle of calling thread
+ * \param[in]       monitor: Jitter monitor of the worker
+ * \param[in]       fn: Operation function, executed by worker thread with bus locked
+ * \param[in]       arg: User argument for function
+ * \return          Result of operation function, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_monitor_call(ow_worker_t* const worker, ow_work_t* const work, ow_sys_posix_monitor_t* const monitor,
+                          const ow_work_fn fn, void* const arg) {
+    ow_sys_posix_timed_t t = { .fn = fn, .arg = arg, .monitor = monitor };
+
+    OW_ASSERT("monitor != NULL", monitor != NULL);
+    OW_ASSERT("fn != NULL", fn != NULL);
+
+    t.submitted = ow_sys_posix_get_time_us();
+    return ow_worker_call(worker, work, prv_timed, &t);
+}
+
+/**
+ * \brief           Read histograms of jitter monitor
+ *
+ * Histograms are copied by worker thread, between two operations
+ *
+ * \param[in]       worker: Worker handle
+ * \param[in]       work: Request handle of calling thread
+ * \param[in]       monitor: Jitter monitor of the worker
+ * \param[out]      out: Output variable to save histograms to
+ * \param[in]       clear: Set to `1` to clear histograms after they are read
+ * \return          \ref owOK on success, member of \ref owr_t otherwise
+ */
+owr_t
+ow_sys_posix_monitor_get(ow_worker_t* const worker, ow_work_t* const work, ow_sys_posix_monitor_t* const monitor,
+                         ow_sys_posix_monitor_t* const out, const uint8_t clear) {
+    ow_sys_posix_read_t r = { .monitor = monitor, .out = out, .clear = clear };
+
+    OW_ASSERT("monitor != NULL", monitor != NULL);
+    OW_ASSERT("out != NULL", out != NULL);
+
+    return ow_worker_call(worker, work, prv_read, &r);
+}
+
+#endif /* OW_CFG_WORKER || __DOXYGEN__ */
+
+#endif /* OW_CFG_OS */
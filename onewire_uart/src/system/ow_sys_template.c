@@ -70,6 +70,19 @@ ow_sys_mutex_wait(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     return 1;
 }
 
+/**
+ * \brief           Wait for a mutex until ready or until timeout expires
+ * \note            Required only when \ref OW_CFG_DEADLINE is enabled
+ * \param[in]       mutex: Mutex handle to wait for
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds, always greater than `0`
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` on timeout or error
+ */
+uint8_t
+ow_sys_mutex_wait_timeout(OW_CFG_OS_MUTEX_HANDLE* mutex, const uint32_t timeout, void* arg) {
+    return 1;
+}
+
 /**
  * \brief           Release already locked mutex
  * \param[in]       mutex: Mutex handle to release
@@ -81,4 +94,80 @@ ow_sys_mutex_release(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     return 1;
 }
 
+/**
+ * \brief           Put current thread to sleep for specific time
+ *
+ * Used while waiting for long device operations, such as temperature conversion,
+ * to release processing time to other threads
+ *
+ * \param[in]       ms: Time to sleep in units of milliseconds
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_sys_delay(const uint32_t ms, void* arg) {
+    return 1;
+}
+
+/**
+ * \brief           Get current system time
+ *
+ * Used to schedule device operations without blocking the bus
+ *
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          Current time in units of milliseconds, free-running and wrapping at `32-bit` boundary
+ */
+uint32_t
+ow_sys_get_tick(void* arg) {
+    return 0;
+}
+
+/**
+ * \brief           Create a new counting semaphore with initial count `0`
+ * \note            Semaphore functions are used only when \ref OW_CFG_WORKER
+ *                  or \ref OW_CFG_ARBITER is enabled
+ * \param[out]      sem: Output variable to save semaphore handle
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_sys_sem_create(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    return 1;
+}
+
+/**
+ * \brief           Delete existing semaphore and invalidate semaphore variable
+ * \param[in]       sem: Semaphore handle to remove and invalidate
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_sys_sem_delete(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    return 1;
+}
+
+/**
+ * \brief           Wait for semaphore to be released and decrease its count
+ * \param[in]       sem: Semaphore handle to wait for
+ * \param[in]       timeout: Maximal time to wait in units of milliseconds. Set to `0` to wait forever
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` on timeout or error
+ */
+uint8_t
+ow_sys_sem_wait(OW_CFG_OS_SEM_HANDLE* sem, const uint32_t timeout, void* arg) {
+    return 1;
+}
+
+/**
+ * \brief           Release semaphore and increase its count
+ * \note            Function may be called from any thread or interrupt context, but must not block
+ * \param[in]       sem: Semaphore handle to release
+ * \param[in]       arg: User argument passed on \ref ow_init function
+ * \return          `1` on success, `0` otherwise
+ */
+uint8_t
+ow_sys_sem_release(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    return 1;
+}
+
 #endif /* OW_CFG_OS || __DOXYGEN__ */
@@ -54,9 +54,48 @@ ow_sys_mutex_wait(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     return WaitForSingleObject(*mutex, INFINITE) == WAIT_OBJECT_0;
 }
 
+uint8_t
+ow_sys_mutex_wait_timeout(OW_CFG_OS_MUTEX_HANDLE* mutex, const uint32_t timeout, void* arg) {
+    return WaitForSingleObject(*mutex, timeout) == WAIT_OBJECT_0;
+}
+
 uint8_t
 ow_sys_mutex_release(OW_CFG_OS_MUTEX_HANDLE* mutex, void* arg) {
     return ReleaseMutex(*mutex);
 }
 
+uint8_t
+ow_sys_delay(const uint32_t ms, void* arg) {
+    Sleep(ms);
+    return 1;
+}
+
+uint32_t
+ow_sys_get_tick(void* arg) {
+    return (uint32_t)GetTickCount();
+}
+
+uint8_t
+ow_sys_sem_create(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    *sem = CreateSemaphore(NULL, 0, LONG_MAX, NULL);
+    return *sem != NULL;
+}
+
+uint8_t
+ow_sys_sem_delete(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    CloseHandle(*sem);
+    *sem = NULL;
+    return 1;
+}
+
+uint8_t
+ow_sys_sem_wait(OW_CFG_OS_SEM_HANDLE* sem, const uint32_t timeout, void* arg) {
+    return WaitForSingleObject(*sem, timeout > 0 ? timeout : INFINITE) == WAIT_OBJECT_0;
+}
+
+uint8_t
+ow_sys_sem_release(OW_CFG_OS_SEM_HANDLE* sem, void* arg) {
+    return ReleaseSemaphore(*sem, 1, NULL);
+}
+
 #endif /* OW_CFG_OS && !__DOXYGEN__ */
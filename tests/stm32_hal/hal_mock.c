@@ -0,0 +1,244 @@
+/**
+ * \file            hal_mock.c
+ * \brief           Host mock of STM32 HAL UART functions
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+#include "main.h"
+
+mock_t mock;
+
+/* Transfer in progress, single UART is used at a time */
+static struct {
+    UART_HandleTypeDef* huart;
+    uint8_t* rx;
+    uint16_t len;
+    uint8_t data[256];                          /* Data received on the line */
+    uint32_t gen;                               /* Incremented on each start and abort */
+    pthread_t irq;
+    uint8_t irq_running;
+} xfer;
+
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Finish transfer, as receive complete interrupt does */
+static void
+prv_complete(void) {
+    memcpy(xfer.rx, xfer.data, xfer.len);
+    xfer.huart->gState = HAL_UART_STATE_READY;
+    xfer.huart->RxState = HAL_UART_STATE_READY;
+    HAL_UART_RxCpltCallback(xfer.huart);
+}
+
+/* Interrupt thread of MOCK_COMPLETE_LATER mode */
+static void*
+prv_irq(void* arg) {
+    uint32_t gen = (uint32_t)(uintptr_t)arg;
+    struct timespec ts = { .tv_sec = mock.delay_ms / 1000, .tv_nsec = (long)(mock.delay_ms % 1000) * 1000000L };
+
+    nanosleep(&ts, NULL);
+    pthread_mutex_lock(&lock);
+    if (gen == xfer.gen) {                      /* Not aborted meanwhile */
+        prv_complete();
+    }
+    pthread_mutex_unlock(&lock);
+    return NULL;
+}
+
+/* Start transmission, line loops data back to receiver */
+static HAL_StatusTypeDef
+prv_transmit(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t size) {
+    if (huart->gState != HAL_UART_STATE_READY || size > sizeof(xfer.data)) {
+        return HAL_BUSY;
+    }
+    mock_wait_idle();
+    pthread_mutex_lock(&lock);
+    huart->gState = HAL_UART_STATE_BUSY_TX;
+    ++mock.tx_calls;
+    mock.tx_brr = huart->Instance->BRR;
+    mock.tx_ue = (huart->Instance->CR1 & USART_CR1_UE) != 0;
+
+    memcpy(xfer.data, data, size);
+    if (size == 1 && data[0] == 0xF0 && mock.tx_ue && mock.tx_brr == MOCK_PCLK / 9600) {
+        xfer.data[0] = 0xE0;                    /* Presence pulse */
+    }
+    xfer.huart = huart;
+    switch (mock.complete) {
+        case MOCK_COMPLETE_NOW:
+            prv_complete();
+            break;
+        case MOCK_COMPLETE_LATER:
+            huart->gState = HAL_UART_STATE_READY;   /* Transmission ends first, only reception is pending */
+            xfer.irq_running = pthread_create(&xfer.irq, NULL, prv_irq, (void*)(uintptr_t)xfer.gen) == 0;
+            break;
+        default:
+            break;
+    }
+    pthread_mutex_unlock(&lock);
+    return HAL_OK;
+}
+
+/* Start reception of `size` bytes */
+static HAL_StatusTypeDef
+prv_receive(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+    if (huart->RxState != HAL_UART_STATE_READY) {
+        return HAL_BUSY;
+    }
+    pthread_mutex_lock(&lock);
+    ++xfer.gen;
+    xfer.rx = data;
+    xfer.len = size;
+    huart->RxState = HAL_UART_STATE_BUSY_RX;
+    pthread_mutex_unlock(&lock);
+    return HAL_OK;
+}
+
+/**
+ * \brief           Reset mock counters and completion mode
+ */
+void
+mock_reset(void) {
+    mock_wait_idle();
+    memset(&mock, 0x00, sizeof(mock));
+}
+
+/**
+ * \brief           Wait for interrupt thread of previous transfer to finish
+ */
+void
+mock_wait_idle(void) {
+    if (xfer.irq_running) {
+        pthread_join(xfer.irq, NULL);
+        xfer.irq_running = 0;
+    }
+}
+
+/**
+ * \brief           Enable UART, used instead of register access
+ * \param[in]       huart: UART handle
+ */
+void
+mock_uart_enable(UART_HandleTypeDef* huart) {
+    if (huart->Instance->CR1 & USART_CR1_UE) {
+        mock.enable_error = 1;                  /* BRR may have been written while enabled */
+    }
+    ++mock.enable_calls;
+    mock.enable_brr = huart->Instance->BRR;
+    huart->Instance->CR1 |= USART_CR1_UE;
+}
+
+/**
+ * \brief           Disable UART, used instead of register access
+ * \param[in]       huart: UART handle
+ */
+void
+mock_uart_disable(UART_HandleTypeDef* huart) {
+    huart->Instance->CR1 &= ~USART_CR1_UE;
+}
+
+uint32_t
+HAL_GetTick(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000);
+}
+
+HAL_StatusTypeDef
+HAL_UART_Init(UART_HandleTypeDef* huart) {
+    ++mock.init_calls;
+    huart->Instance->BRR = MOCK_PCLK / huart->Init.BaudRate;
+    huart->Instance->CR1 |= USART_CR1_UE;
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef
+HAL_UART_DeInit(UART_HandleTypeDef* huart) {
+    huart->Instance->CR1 &= ~USART_CR1_UE;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef
+HAL_UART_Transmit(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size, uint32_t timeout) {
+    HAL_StatusTypeDef res;
+
+    (void)timeout;
+    if ((res = prv_transmit(huart, data, size)) == HAL_OK) {
+        while (huart->gState != HAL_UART_STATE_READY) {}
+    }
+    return res;
+}
+
+HAL_StatusTypeDef
+HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+    return prv_transmit(huart, data, size);
+}
+
+HAL_StatusTypeDef
+HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+    return prv_receive(huart, data, size);
+}
+
+HAL_StatusTypeDef
+HAL_UART_Abort(UART_HandleTypeDef* huart) {
+    pthread_mutex_lock(&lock);
+    ++mock.abort_calls;
+    ++xfer.gen;                                 /* Pending interrupt does not complete anymore */
+    huart->gState = HAL_UART_STATE_READY;
+    huart->RxState = HAL_UART_STATE_READY;
+    pthread_mutex_unlock(&lock);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef
+HAL_UART_AbortReceive(UART_HandleTypeDef* huart) {
+    pthread_mutex_lock(&lock);
+    ++xfer.gen;
+    huart->RxState = HAL_UART_STATE_READY;
+    pthread_mutex_unlock(&lock);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef
+HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+    ++mock.dma_calls;
+    return prv_transmit(huart, data, size);
+}
+
+HAL_StatusTypeDef
+HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size) {
+    ++mock.dma_calls;
+    return prv_receive(huart, data, size);
+}
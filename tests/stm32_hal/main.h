@@ -0,0 +1,132 @@
+/**
+ * \file            main.h
+ * \brief           Host mock of STM32 HAL UART functions used by low-level drivers
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_TEST_HAL_MOCK_H
+#define OW_HDR_TEST_HAL_MOCK_H
+
+/*
+ * Replaces main.h generated by CubeMX, when low-level drivers are compiled on host.
+ * Only types, registers and functions used by drivers are provided.
+ *
+ * UART loops transmitted data back to receiver, as with 1-Wire line and no device pulling it low.
+ * Reset byte transmitted at reset baudrate is received as presence pulse of single device.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+typedef enum {
+    HAL_OK = 0x00,
+    HAL_ERROR = 0x01,
+    HAL_BUSY = 0x02,
+    HAL_TIMEOUT = 0x03,
+} HAL_StatusTypeDef;
+
+#define HAL_UART_STATE_READY                    0x20U
+#define HAL_UART_STATE_BUSY_TX                  0x21U
+#define HAL_UART_STATE_BUSY_RX                  0x22U
+
+typedef struct {
+    volatile uint32_t CR1;
+    volatile uint32_t BRR;
+} USART_TypeDef;
+
+#define USART_CR1_UE                            0x00000001U
+
+typedef struct {
+    uint32_t BaudRate;
+} UART_InitTypeDef;
+
+typedef struct __UART_HandleTypeDef {
+    USART_TypeDef* Instance;
+    UART_InitTypeDef Init;
+    volatile uint32_t gState;
+    volatile uint32_t RxState;
+} UART_HandleTypeDef;
+
+#define __HAL_UART_ENABLE(h)                    mock_uart_enable(h)
+#define __HAL_UART_DISABLE(h)                   mock_uart_disable(h)
+
+uint32_t            HAL_GetTick(void);
+HAL_StatusTypeDef   HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef   HAL_UART_DeInit(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef   HAL_UART_Transmit(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size, uint32_t timeout);
+HAL_StatusTypeDef   HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+HAL_StatusTypeDef   HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+HAL_StatusTypeDef   HAL_UART_Abort(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef   HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef   HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+HAL_StatusTypeDef   HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* data, uint16_t size);
+void                HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+
+/* Mock control */
+
+/* Peripheral clock, BRR = MOCK_PCLK / baudrate */
+#define MOCK_PCLK                               48000000U
+
+/* When transfer completes after it is started */
+typedef enum {
+    MOCK_COMPLETE_NOW,                          /* Before transmit function returns, before driver waits */
+    MOCK_COMPLETE_LATER,                        /* Reception from interrupt thread, after `delay_ms` */
+    MOCK_COMPLETE_NEVER,                        /* Line is stuck, only abort stops the transfer */
+} mock_complete_t;
+
+typedef struct {
+    mock_complete_t complete;                   /* Completion mode of next transfers */
+    uint32_t delay_ms;                          /* Delay of MOCK_COMPLETE_LATER mode */
+    uint32_t init_calls;                        /* Number of HAL_UART_Init calls */
+    uint32_t abort_calls;                       /* Number of HAL_UART_Abort calls */
+    uint32_t tx_calls;                          /* Number of started transmissions */
+    uint32_t tx_brr;                            /* BRR register value at start of last transmission */
+    uint32_t tx_ue;                             /* Set to `1` when UART was enabled at start of last transmission */
+    uint32_t dma_calls;                         /* Number of started DMA transfers, both directions */
+    uint32_t enable_calls;                      /* Number of UART enables with __HAL_UART_ENABLE */
+    uint32_t enable_brr;                        /* BRR register value at last UART enable */
+    uint32_t enable_error;                      /* Set to `1` when UART was enabled without being disabled before */
+} mock_t;
+
+extern mock_t mock;
+
+void        mock_reset(void);
+void        mock_wait_idle(void);
+void        mock_uart_enable(UART_HandleTypeDef* huart);
+void        mock_uart_disable(UART_HandleTypeDef* huart);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* OW_HDR_TEST_HAL_MOCK_H */
@@ -0,0 +1,56 @@
+/**
+ * \file            test.h
+ * \brief           Minimal assertion helpers of host tests
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#ifndef OW_HDR_TEST_H
+#define OW_HDR_TEST_H
+
+#include <stdio.h>
+
+static int test_failed;
+
+/* Check condition, report failure and continue */
+#define TEST_CHECK(c)           do {                                        \
+    if (!(c)) {                                                             \
+        printf("%s:%d: check failed: %s\r\n", __FILE__, __LINE__, #c);     \
+        ++test_failed;                                                      \
+    }                                                                       \
+} while (0)
+
+/* Run single test function */
+#define TEST_RUN(fn)            do {                                        \
+    int failed = test_failed;                                               \
+    fn();                                                                   \
+    printf("%s: %s\r\n", failed == test_failed ? "PASS" : "FAIL", #fn);     \
+} while (0)
+
+#endif /* OW_HDR_TEST_H */
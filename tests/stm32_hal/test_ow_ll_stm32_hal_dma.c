@@ -0,0 +1,186 @@
+/**
+ * \file            test_ow_ll_stm32_hal_dma.c
+ * \brief           Host test of STM32 HAL low-level driver with DMA
+ */
+
+/*
+ * Copyright (c) 2020 Tilen MAJERLE
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge,
+ * publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE
+ * AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * This file is part of OneWire-UART library.
+ *
+ * Author:          Tilen MAJERLE <tilen@majerle.eu>
+ * Version:         v2.0.0
+ */
+#include <string.h>
+#include "main.h"
+#include "ow/ow.h"
+#include "test.h"
+
+void ow_ll_stm32_hal_dma_rx_complete(UART_HandleTypeDef* huart);
+
+extern const ow_ll_drv_t ow_ll_drv_stm32_hal_dma;
+
+static USART_TypeDef usart;
+static UART_HandleTypeDef huart = { .Instance = &usart, .Init = { .BaudRate = 115200 } };
+static ow_t ow;
+
+/* Exchange pattern directly with driver */
+static uint8_t
+prv_exchange(uint8_t* rx) {
+    static const uint8_t tx[8] = { 0x00, 0xFF, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0xFF };
+
+    memset(rx, 0x55, sizeof(tx));
+    return ow_ll_drv_stm32_hal_dma.tx_rx(tx, rx, sizeof(tx), &huart) && memcmp(tx, rx, sizeof(tx)) == 0;
+}
+
+/* Transfer completes normally, reset detects presence */
+static void
+test_transfer(void) {
+    uint8_t rx[8];
+
+    mock_reset();
+    TEST_CHECK(ow_reset(&ow) == owOK);
+    TEST_CHECK(mock.tx_brr == MOCK_PCLK / OW_BAUD_RESET);
+    TEST_CHECK(usart.BRR == MOCK_PCLK / OW_BAUD_DATA);
+    TEST_CHECK(prv_exchange(rx));
+    TEST_CHECK(mock.dma_calls == 2 * mock.tx_calls);
+    TEST_CHECK(mock.abort_calls == 0);
+}
+
+/* Baudrate change writes cached register values, UART is not initialized again */
+static void
+test_set_baudrate(void) {
+    mock_reset();
+    TEST_CHECK(ow_ll_drv_stm32_hal_dma.set_baudrate(OW_BAUD_RESET, &huart));
+    TEST_CHECK(usart.BRR == MOCK_PCLK / OW_BAUD_RESET);
+    TEST_CHECK(mock.enable_calls == 1 && mock.enable_brr == MOCK_PCLK / OW_BAUD_RESET);
+    TEST_CHECK(ow_ll_drv_stm32_hal_dma.set_baudrate(OW_BAUD_DATA, &huart));
+    TEST_CHECK(usart.BRR == MOCK_PCLK / OW_BAUD_DATA);
+    TEST_CHECK(mock.enable_calls == 2 && mock.enable_brr == MOCK_PCLK / OW_BAUD_DATA);
+    TEST_CHECK(!mock.enable_error);
+    TEST_CHECK(usart.CR1 & USART_CR1_UE);
+    TEST_CHECK(!ow_ll_drv_stm32_hal_dma.set_baudrate(57600, &huart));
+    TEST_CHECK(mock.init_calls == 0);
+}
+
+/* Receive completes before driver starts to wait, semaphore holds the count */
+static void
+test_complete_before_wait(void) {
+    uint8_t rx[8];
+
+    mock_reset();
+    mock.complete = MOCK_COMPLETE_NOW;
+    for (int i = 0; i < 10; ++i) {
+        TEST_CHECK(prv_exchange(rx));
+    }
+    TEST_CHECK(mock.tx_calls == 10);
+    TEST_CHECK(mock.abort_calls == 0);
+}
+
+/* Completion arrives from interrupt while driver sleeps */
+static void
+test_complete_later(void) {
+    uint8_t rx[8];
+    uint32_t start;
+
+    mock_reset();
+    mock.complete = MOCK_COMPLETE_LATER;
+    mock.delay_ms = 20;
+    start = HAL_GetTick();
+    TEST_CHECK(prv_exchange(rx));
+    TEST_CHECK(HAL_GetTick() - start >= 20);
+    TEST_CHECK(mock.abort_calls == 0);
+    mock_wait_idle();
+}
+
+/* Stuck line, transfer times out and is aborted, next transfer works */
+static void
+test_timeout_abort(void) {
+    uint8_t rx[8];
+    uint32_t start, elapsed;
+
+    mock_reset();
+    mock.complete = MOCK_COMPLETE_NEVER;
+    start = HAL_GetTick();
+    TEST_CHECK(!prv_exchange(rx));
+    elapsed = HAL_GetTick() - start;
+    TEST_CHECK(elapsed >= 100 && elapsed < 200);
+    TEST_CHECK(mock.abort_calls == 1);
+    TEST_CHECK(huart.RxState == HAL_UART_STATE_READY);
+    TEST_CHECK(huart.gState == HAL_UART_STATE_READY);
+
+    mock.complete = MOCK_COMPLETE_NOW;
+    TEST_CHECK(prv_exchange(rx));
+    TEST_CHECK(mock.abort_calls == 1);
+}
+
+/* Late release of aborted transfer wakes up next one, RX state is checked again */
+static void
+test_stale_release(void) {
+    uint8_t rx[8];
+    uint32_t start;
+
+    mock_reset();
+    ow_ll_stm32_hal_dma_rx_complete(&huart);    /* Stale count */
+    mock.complete = MOCK_COMPLETE_LATER;
+    mock.delay_ms = 30;
+    start = HAL_GetTick();
+    TEST_CHECK(prv_exchange(rx));               /* Data valid only when driver waited for real completion */
+    TEST_CHECK(HAL_GetTick() - start >= 30);
+    TEST_CHECK(mock.abort_calls == 0);
+    mock_wait_idle();
+}
+
+/* Deadline shorter than transfer aborts it */
+static void
+test_timeout_argument(void) {
+    static const uint8_t tx[8];
+    uint8_t rx[8];
+    uint32_t start, elapsed;
+
+    mock_reset();
+    mock.complete = MOCK_COMPLETE_NEVER;
+    start = HAL_GetTick();
+    TEST_CHECK(!ow_ll_drv_stm32_hal_dma.tx_rx_timeout(tx, rx, sizeof(tx), 20, &huart));
+    elapsed = HAL_GetTick() - start;
+    TEST_CHECK(elapsed >= 20 && elapsed < 100);
+    TEST_CHECK(mock.abort_calls == 1);
+}
+
+int
+main(void) {
+    mock_reset();
+    if (ow_init(&ow, &ow_ll_drv_stm32_hal_dma, &huart) != owOK || mock.init_calls != 2) {
+        printf("FAIL: ow_init\r\n");
+        return 1;
+    }
+    TEST_RUN(test_transfer);
+    TEST_RUN(test_set_baudrate);
+    TEST_RUN(test_complete_before_wait);
+    TEST_RUN(test_complete_later);
+    TEST_RUN(test_timeout_abort);
+    TEST_RUN(test_stale_release);
+    TEST_RUN(test_timeout_argument);
+    ow_deinit(&ow);
+    return test_failed > 0;
+}